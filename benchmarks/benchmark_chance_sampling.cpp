@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mcts/alias_table.h"
+#include "mcts/selection/ucb1.h"
+#include "zbo/max_size_vector.h"
+#include "zbo/stop_watch.h"
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+
+/**
+ * Compares sampling a chance event with the alias table of the chance nodes against the linear search over the
+ * cumulative probabilities that was used before, for the number of events of 2048 chance nodes (two events per empty
+ * cell with the probabilities 0.8 and 0.2 of a 2 and a 4 tile)
+ */
+
+constexpr size_t MAX_EVENTS = 32;
+constexpr size_t NUM_SAMPLES = 1U << 24U;
+constexpr std::array<size_t, 4> NUM_EVENTS = {2, 8, 16, 32};
+
+using Events = zbo::MaxSizeVector<std::pair<float, int>, MAX_EVENTS>;
+
+/// Minimal node type that provides everything the chance sampling of a selection policy needs
+struct BenchmarkNode
+{
+    struct DecisionNode
+    {
+    };
+    struct ChanceNode
+    {
+        Events events{};
+        std::shared_ptr<const mcts::AliasTable<MAX_EVENTS>> sampler{};
+    };
+};
+
+Events generateEvents(size_t numEvents)
+{
+    constexpr float PROBABILITY_SPAWN_2 = 0.8f;
+    Events events{};
+    const float probabilityPerCell = 2.0f / float(numEvents);
+    for (size_t i = 0; i < numEvents; ++i)
+    {
+        const float probability = i % 2 == 0 ? PROBABILITY_SPAWN_2 : 1 - PROBABILITY_SPAWN_2;
+        events.push_back({probabilityPerCell * probability, int(i)});
+    }
+    return events;
+}
+
+/// the previous sampling: walk the events until the uniform random number falls into the probability of an event
+size_t sampleLinear(const Events& events, std::minstd_rand0& engine, std::uniform_real_distribution<float>& dist)
+{
+    float randVal = dist(engine);
+    size_t counter = 0;
+    for (const auto& ev : events)
+    {
+        if (randVal < ev.first) { return counter; }
+        randVal -= ev.first;
+        counter++;
+    }
+    return events.size() - 1;
+}
+
+void printResult(const std::string& name, size_t numEvents, std::chrono::nanoseconds duration, size_t checksum)
+{
+    constexpr int NAME_WIDTH = 12;
+    std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::setw(3) << numEvents << " events: "
+              << std::setw(8) << std::fixed << std::setprecision(3) << double(duration.count()) / double(NUM_SAMPLES)
+              << " ns/sample  (mean index " << double(checksum) / double(NUM_SAMPLES) << ")\n";
+}
+
+int main(int, char**)
+{
+    constexpr unsigned SEED = 42;
+    std::cout << "#### Sampling of chance events\n";
+    for (const size_t numEvents : NUM_EVENTS)
+    {
+        BenchmarkNode::ChanceNode chance{generateEvents(numEvents)};
+        auto sampler = std::make_shared<mcts::AliasTable<MAX_EVENTS>>();
+        sampler->build(chance.events, [](const auto& event) { return event.first; });
+        chance.sampler = std::move(sampler);
+
+        {
+            std::minstd_rand0 engine{SEED};
+            std::uniform_real_distribution<float> dist{0, 1.0f};
+            zbo::StopWatch watch;
+            watch.start();
+            size_t checksum = 0;
+            for (size_t i = 0; i < NUM_SAMPLES; ++i) { checksum += sampleLinear(chance.events, engine, dist); }
+            printResult("Linear", numEvents, watch.stop(), checksum);
+        }
+        {
+            mcts::UCB1SelectionPolicy<float> policy{};
+            policy.seed(SEED);
+            const BenchmarkNode node{};
+            zbo::StopWatch watch;
+            watch.start();
+            size_t checksum = 0;
+            for (size_t i = 0; i < NUM_SAMPLES; ++i) { checksum += policy(node, chance); }
+            printResult("AliasTable", numEvents, watch.stop(), checksum);
+        }
+    }
+    return 0;
+}
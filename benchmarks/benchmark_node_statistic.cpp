@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mcts/node_statistic.h"
+#include "mcts/selection/ucb1.h"
+#include "mcts/selection/ucb1_tuned.h"
+#include "mcts/selection/ucb_v.h"
+#include "zbo/stop_watch.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Measures the cost of the additional variance accumulator of VarianceStatistic compared to the plain Statistic, both
+ * for backpropagation (visitWithValue) and for the selection policies that make use of them
+ */
+
+constexpr int NUM_ACTIONS = 4;
+constexpr size_t NUM_VALUES = 1U << 20U;
+constexpr size_t NUM_REPETITIONS = 20;
+
+/// Minimal node type that provides everything a selection policy needs
+template <typename StatisticType>
+struct BenchmarkNode
+{
+    struct DecisionNode
+    {
+        mcts::NodeStatistic<float, NUM_ACTIONS, StatisticType> statistics{};
+    };
+    struct ChanceNode
+    {
+    };
+};
+
+std::vector<float> generateValues()
+{
+    std::minstd_rand0 engine{42};                        // NOLINT
+    std::exponential_distribution<float> values{0.01f};  // NOLINT (heavy tailed like 2048 rollout returns)
+    std::vector<float> retval(NUM_VALUES);
+    for (auto& v : retval) { v = values(engine); }
+    return retval;
+}
+
+void printResult(const std::string& name, std::chrono::nanoseconds duration, size_t numOperations, float checksum)
+{
+    constexpr int NAME_WIDTH = 40;
+    std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::setw(8) << std::fixed
+              << std::setprecision(3) << double(duration.count()) / double(numOperations) << " ns/op"
+              << "  (checksum " << checksum << ")\n";
+}
+
+template <typename StatisticType>
+void benchmarkBackpropagation(const std::string& name, const std::vector<float>& values)
+{
+    zbo::StopWatch watch;
+    watch.start();
+    float checksum = 0;
+    for (size_t rep = 0; rep < NUM_REPETITIONS; ++rep)
+    {
+        mcts::NodeStatistic<float, NUM_ACTIONS, StatisticType> statistic{};
+        for (size_t i = 0; i < values.size(); ++i) { statistic.visitWithValue(i % NUM_ACTIONS, values[i]); }
+        checksum += statistic.stat(0).value();
+    }
+    printResult(name, watch.stop(), NUM_REPETITIONS * values.size(), checksum);
+}
+
+template <typename SelectionPolicy>
+void benchmarkSelection(const std::string& name, SelectionPolicy policy, const std::vector<float>& values)
+{
+    using Node = BenchmarkNode<typename SelectionPolicy::StatisticType>;
+    typename Node::DecisionNode decision{};
+    for (size_t i = 0; i < values.size(); ++i) { decision.statistics.visitWithValue(i % NUM_ACTIONS, values[i]); }
+
+    const Node node{};
+    zbo::StopWatch watch;
+    watch.start();
+    size_t checksum = 0;
+    for (size_t i = 0; i < values.size(); ++i) { checksum += policy.selectDecisionNodeSuccessor(node, decision); }
+    printResult(name, watch.stop(), values.size(), float(checksum));
+}
+
+int main(int, char**)
+{
+    const auto values = generateValues();
+
+    std::cout << "#### Backpropagation (NodeStatistic::visitWithValue)\n";
+    benchmarkBackpropagation<mcts::Statistic<float>>("Statistic", values);
+    benchmarkBackpropagation<mcts::VarianceStatistic<float>>("VarianceStatistic", values);
+
+    std::cout << "#### Selection (" << NUM_ACTIONS << " actions)\n";
+    constexpr float MAX_VALUE = 500;
+    benchmarkSelection("UCB1", mcts::UCB1SelectionPolicy<float>({0, MAX_VALUE, 5}), values);  // NOLINT
+    benchmarkSelection("UCB1-Tuned", mcts::UCB1TunedSelectionPolicy<float>({0, MAX_VALUE, 1}), values);
+    benchmarkSelection("UCB-V", mcts::UCBVSelectionPolicy<float>({0, MAX_VALUE, 1.2f, 1}), values);  // NOLINT
+    return 0;
+}
@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mcts/rollout/rollout.h"
+#include "mcts/selection/ucb1.h"
+#include "mcts/solver.h"
+#include "synthetic_problem.h"
+#include "zbo/stop_watch.h"
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * Sweeps the shape of synthetic trees to find out where the tree, the node statistics and the solver stop scaling:
+ * the size of the tree, the branching factor, the maximal number of actions (which fixes the size of every node),
+ * chance nodes, the number of players and the cost of the game logic.
+ * The solver reserves the nodes for the worst case (every iteration expands the maximal number of actions), so the
+ * number of iterations is limited by the maximal number of actions and not by the branching factor of the tree
+ */
+
+using namespace synthetic;
+
+constexpr size_t DEFAULT_ITERATIONS = 10000;
+constexpr size_t FEW_ITERATIONS = 2000;
+
+template <int MAX_ACTIONS, int MAX_EVENTS = 0, int PLAYERS = 1>
+void benchmark(const std::string& name, const SyntheticConfig& config, size_t iterations = DEFAULT_ITERATIONS)
+{
+    using Problem = SyntheticProblem<MAX_ACTIONS, MAX_EVENTS, PLAYERS>;
+    using Solver = mcts::Solver<Problem, mcts::UCB1SelectionPolicy<float>, mcts::RolloutPolicy<SyntheticPolicy>>;
+
+    const Problem problem(config);
+    Solver solver{};
+    solver.parameter().numIterations = iterations;
+    solver.seed(config.seed);
+
+    zbo::StopWatch watch;
+    watch.start();
+    const auto action = solver.run(problem, problem.root());
+    const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(watch.stop());
+
+    constexpr int NAME_WIDTH = 28;
+    constexpr double MEGABYTE = 1024.0 * 1024.0;
+    constexpr double NANOSECONDS = 1e9;
+    const size_t numNodes = solver.tree().nodeCount();
+    std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(9) << double(iterations) / duration.count() << " iterations/s, " << std::setw(8)
+              << numNodes << " nodes of " << std::setw(5) << sizeof(typename Solver::Node) << " bytes ("
+              << std::setprecision(1) << std::setw(7) << double(numNodes * sizeof(typename Solver::Node)) / MEGABYTE
+              << " MB), " << std::setw(7) << duration.count() * NANOSECONDS / double(numNodes)
+              << " ns/node, action " << int(action) << "\n";
+}
+
+int main(int, char**)
+{
+    constexpr size_t MAX_ACTIONS = 32;
+    const SyntheticConfig base{};
+
+    std::cout << "#### Size of the tree (branching factor " << base.branchingFactor << ", depth " << base.depth
+              << "):\n";
+    for (const size_t iterations : {1000, 10000, 100000})
+    {
+        benchmark<8>(std::to_string(iterations) + " iterations", base, iterations);
+    }
+
+    std::cout << "#### Branching factor (" << MAX_ACTIONS << " actions at most):\n";
+    for (const size_t branchingFactor : {2, 8, 32})
+    {
+        SyntheticConfig config = base;
+        config.branchingFactor = branchingFactor;
+        benchmark<MAX_ACTIONS>("branching factor " + std::to_string(branchingFactor), config);
+    }
+
+    std::cout << "#### Maximal number of actions (branching factor " << base.branchingFactor << ", " << FEW_ITERATIONS
+              << " iterations):\n";
+    benchmark<8>("8 actions at most", base, FEW_ITERATIONS);
+    benchmark<32>("32 actions at most", base, FEW_ITERATIONS);
+    benchmark<128>("128 actions at most", base, FEW_ITERATIONS);
+    benchmark<256>("256 actions at most", base, FEW_ITERATIONS);
+
+    std::cout << "#### Chance nodes (8 events):\n";
+    for (const float fraction : {0.0f, 0.25f, 0.5f})
+    {
+        SyntheticConfig config = base;
+        config.numEvents = 8;  // NOLINT
+        config.chanceFraction = fraction;
+        benchmark<MAX_ACTIONS, 8>("chance fraction " + std::to_string(fraction).substr(0, 4), config);
+    }
+
+    std::cout << "#### Players:\n";
+    benchmark<MAX_ACTIONS, 0, 1>("1 player", base);
+    benchmark<MAX_ACTIONS, 0, 2>("2 players", base);
+    benchmark<MAX_ACTIONS, 0, 4>("4 players", base);
+
+    std::cout << "#### Work per step (rounds of hashing):\n";
+    for (const size_t work : {0, 10, 100})
+    {
+        SyntheticConfig config = base;
+        config.workPerStep = work;
+        benchmark<MAX_ACTIONS>(std::to_string(work) + " rounds", config);
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "mcts/problem.h"
+#include "mcts/random.h"
+#include "mcts/state.h"
+#include "zbo/max_size_vector.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <type_traits>
+
+namespace synthetic {
+
+/// Shape of the trees of a SyntheticProblem
+struct SyntheticConfig
+{
+    static constexpr size_t DEFAULT_BRANCHING_FACTOR = 8;
+    static constexpr size_t DEFAULT_DEPTH = 20;
+
+    /// actions of every decision, at most the MAX_ACTIONS of the problem
+    size_t branchingFactor = DEFAULT_BRANCHING_FACTOR;
+    /// events of every chance stage, at most the MAX_EVENTS of the problem
+    size_t numEvents = 2;
+    /// steps (decisions and chance events) until the game ends
+    size_t depth = DEFAULT_DEPTH;
+    /// probability that a step is a chance event instead of a decision, needs MAX_EVENTS > 0
+    float chanceFraction = 0;
+    /// rounds of hashing per step, to simulate the cost of the game logic of real problems
+    size_t workPerStep = 0;
+    /// selects one of the trees with this shape and seeds the sampling of chance events
+    uint64_t seed = 0;
+};
+
+class SyntheticState : public mcts::State<SyntheticState>
+{
+  public:
+    std::ostream& writeToStream(std::ostream& stream) const
+    {
+        stream << "Hash: " << hash << ", depth: " << depth << (chanceNext ? " (chance)" : "") << "\n";
+        return mcts::State<SyntheticState>::writeToStream(stream);
+    }
+
+    [[nodiscard]] bool operator==(const SyntheticState& rhs) const
+    {
+        return hash == rhs.hash && depth == rhs.depth && getCurrentPlayer() == rhs.getCurrentPlayer();
+    }
+
+    /// identifies the path from the root, everything else (stage type, rewards, events) is derived from it
+    uint64_t hash{};
+    uint32_t depth{};
+    bool chanceNext{false};
+    /// result of the artificial work, only stored so that it can not be optimized away
+    uint64_t work{};
+};
+
+template <int MAX_ACTIONS, int MAX_EVENTS, int PLAYERS>
+struct SyntheticDefinition
+{
+    using ValueType = float;
+    using ActionType = uint8_t;
+    using ChanceEventType = uint8_t;
+    using StateType = SyntheticState;
+
+    static constexpr int NUM_PLAYERS = PLAYERS;
+    static constexpr int MAX_NUM_ACTIONS = MAX_ACTIONS;
+    static constexpr int MAX_CHANCE_EVENTS = MAX_EVENTS;
+
+    using ValueVector = std::conditional_t<PLAYERS == 1, float, std::array<float, PLAYERS>>;
+};
+
+/**
+ * @brief Problem with trees of a configurable shape (see SyntheticConfig) to benchmark the solver independent of a
+ * real game. The maximal number of actions, events and the players are template parameters, as they determine the
+ * memory layout of the tree.
+ * States are identified by a hash of the path from the root, which is seeded. The stage type, the rewards (uniform in
+ * [0, 1 / depth) per step and player) and the probabilities of the chance events are derived from it, so that
+ * equal configs give equal trees and searches are deterministic for a seeded solver
+ */
+template <int MAX_ACTIONS, int MAX_EVENTS = 0, int PLAYERS = 1>
+class SyntheticProblem : public mcts::Problem<SyntheticProblem<MAX_ACTIONS, MAX_EVENTS, PLAYERS>,
+                                              SyntheticDefinition<MAX_ACTIONS, MAX_EVENTS, PLAYERS>>
+{
+  public:
+    using Definition = SyntheticDefinition<MAX_ACTIONS, MAX_EVENTS, PLAYERS>;
+    using ValueVector = typename Definition::ValueVector;
+    using ActionType = typename Definition::ActionType;
+    using ChanceEventType = typename Definition::ChanceEventType;
+
+    explicit SyntheticProblem(const SyntheticConfig& config) : config_(config), engine_(config.seed)
+    {
+        assert(config.branchingFactor > 0 && config.branchingFactor <= size_t(MAX_ACTIONS));
+        assert(config.chanceFraction <= 0 || (config.numEvents > 0 && config.numEvents <= size_t(MAX_EVENTS)));
+    }
+
+    [[nodiscard]] const SyntheticConfig& config() const { return config_; }
+
+    /// the root of the tree of the config, which is always a decision as the solver searches for the best action
+    [[nodiscard]] SyntheticState root() const
+    {
+        SyntheticState state{};
+        state.hash = mcts::splitMix64(config_.seed);
+        return state;
+    }
+
+    [[nodiscard]] mcts::StageType getNextStageType(const SyntheticState& state) const
+    {
+        return state.chanceNext ? mcts::StageType::CHANCE : mcts::StageType::DECISION;
+    }
+
+    [[nodiscard]] zbo::MaxSizeVector<ActionType, MAX_ACTIONS> getAvailableActions(const SyntheticState& state) const
+    {
+        zbo::MaxSizeVector<ActionType, MAX_ACTIONS> actions{};
+        if (isTerminal(state) || state.chanceNext) { return actions; }
+        for (size_t action = 0; action < config_.branchingFactor; ++action)
+        {
+            actions.push_back(static_cast<ActionType>(action));
+        }
+        return actions;
+    }
+
+    ValueVector performAction(const ActionType action, SyntheticState& state) const
+    {
+        assert(!state.chanceNext && action < config_.branchingFactor);
+        const ValueVector rewards = step(action, state);
+        state.increasePlayer(PLAYERS);
+        return rewards;
+    }
+
+    [[nodiscard]] zbo::MaxSizeVector<std::pair<float, ChanceEventType>, MAX_EVENTS> getAvailableChanceEvents(
+        const SyntheticState& state) const
+    {
+        zbo::MaxSizeVector<std::pair<float, ChanceEventType>, MAX_EVENTS> events{};
+        if (!state.chanceNext) { return events; }
+
+        // weights between 0.5 and 1.5, so that all events are likely enough to be sampled
+        float sum = 0;
+        for (size_t event = 0; event < config_.numEvents; ++event)
+        {
+            const float weight = 0.5f + unit(mcts::splitMix64(state.hash + event + 1));  // NOLINT
+            events.push_back({weight, static_cast<ChanceEventType>(event)});
+            sum += weight;
+        }
+        for (auto& event : events) { event.first /= sum; }
+        return events;
+    }
+
+    ValueVector performChanceEvent(const ChanceEventType event, SyntheticState& state) const
+    {
+        assert(state.chanceNext && event < config_.numEvents);
+        return step(event, state);
+    }
+
+    ValueVector performRandomChanceEvent(SyntheticState& state) const
+    {
+        const auto events = getAvailableChanceEvents(state);
+        float random = std::uniform_real_distribution<float>{0, 1}(engine_.get());
+        for (const auto& [probability, event] : events)
+        {
+            if (random < probability) { return performChanceEvent(event, state); }
+            random -= probability;
+        }
+        return performChanceEvent(events.back().second, state);
+    }
+
+    [[nodiscard]] bool isTerminal(const SyntheticState& state) const { return state.depth >= config_.depth; }
+
+  private:
+    /// uniform number in [0, 1) from the upper 24 bits of the hash
+    static float unit(uint64_t hash)
+    {
+        constexpr uint32_t MANTISSA_BITS = 24;
+        return float(hash >> (64U - MANTISSA_BITS)) / float(1U << MANTISSA_BITS);
+    }
+
+    [[nodiscard]] bool isChance(uint64_t hash) const
+    {
+        constexpr uint64_t CHANCE_SALT = 0x5851F42D4C957F2DULL;
+        return config_.chanceFraction > 0 && unit(mcts::splitMix64(hash ^ CHANCE_SALT)) < config_.chanceFraction;
+    }
+
+    /// moves the state to the child with the given index and returns the rewards of the step
+    ValueVector step(size_t child, SyntheticState& state) const
+    {
+        constexpr uint64_t CHILD_SALT = 0x9E3779B97F4A7C15ULL;
+        state.hash = mcts::splitMix64(state.hash + (child + 1) * CHILD_SALT);
+        state.depth++;
+        state.chanceNext = isChance(state.hash);
+
+        uint64_t work = state.hash;
+        for (size_t round = 0; round < config_.workPerStep; ++round) { work = mcts::splitMix64(work); }
+        state.work = work;
+
+        const float scale = 1.0f / float(config_.depth);
+        if constexpr (PLAYERS == 1) { return scale * unit(state.hash); }
+        else
+        {
+            ValueVector rewards{};
+            for (size_t player = 0; player < PLAYERS; ++player)
+            {
+                rewards[player] = scale * unit(mcts::splitMix64(state.hash + player));
+            }
+            return rewards;
+        }
+    }
+
+    SyntheticConfig config_;
+    /// draws the random chance events of rollouts, reproducible per thread stream for a given SyntheticConfig::seed
+    mcts::ThreadLocalEngine engine_;
+};
+
+/// Plays a random action without generating the list of actions
+class SyntheticPolicy
+{
+  public:
+    template <class ProblemType>
+    typename ProblemType::ActionType getAction(const SyntheticState&, const ProblemType& problem) const
+    {
+        return static_cast<typename ProblemType::ActionType>(engine_() % problem.config().branchingFactor);
+    }
+
+    void seed(uint64_t seed) { engine_.seed(seed); }
+
+  private:
+    mcts::ThreadLocalEngine engine_{};
+};
+}  // namespace synthetic
@@ -14,7 +14,7 @@ bool G2048State::empty(size_t x, size_t y) const
 }
 bool G2048State::operator==(const G2048State& rhs) const
 {
-    return board_ == rhs.board_ && nextIsChance_ == rhs.nextIsChance_;
+    return board_ == rhs.board_ && nextIsChance_ == rhs.nextIsChance_ && spawnCell_ == rhs.spawnCell_;
 }
 bool G2048State::operator!=(const G2048State& rhs) const
 {
@@ -53,11 +53,11 @@ mcts::StageType G2048Problem::getNextStageType(const G2048State& state)
     if (state.isChanceNext()) { return {}; }
 
     zbo::MaxSizeVector<Actions, 4> retval{};
-    auto can = canMove(state);
-    if (can.up) { retval.push_back(UP); }
-    if (can.left) { retval.push_back(LEFT); }
-    if (can.right) { retval.push_back(RIGHT); }
-    if (can.down) { retval.push_back(DOWN); }
+    const uint8_t legal = state.board().legalMoves();
+    if ((legal & MOVE_UP) != 0) { retval.push_back(UP); }
+    if ((legal & MOVE_LEFT) != 0) { retval.push_back(LEFT); }
+    if ((legal & MOVE_RIGHT) != 0) { retval.push_back(RIGHT); }
+    if ((legal & MOVE_DOWN) != 0) { retval.push_back(DOWN); }
     return retval;
 };
 
@@ -70,20 +70,32 @@ mcts::StageType G2048Problem::getNextStageType(const G2048State& state)
     zbo::MaxSizeVector<std::pair<float, ChanceEvent>, NUM_CELLS * 2> retval;
     if (!state.isChanceNext()) { return retval; }
 
+    if (state.spawnCell() != G2048State::NO_SPAWN_CELL)
+    {
+        // second stage of the factored events, the value of the tile on the chosen cell
+        const auto x = static_cast<uint8_t>(state.spawnCell() % BOARD_DIMS);
+        const auto y = static_cast<uint8_t>(state.spawnCell() / BOARD_DIMS);
+        retval.push_back(std::make_pair(PROBABILITY_SPAWN_2, ChanceEvent{x, y, 1}));
+        retval.push_back(std::make_pair(PROBABILITY_SPAWN_4, ChanceEvent{x, y, 2}));
+        return retval;
+    }
+
     size_t numEmpty = countEmptyCells(state);
 
     const float probabilityPerCell = 1 / float(numEmpty);
 
-    for (uint8_t x = 0; x < BOARD_DIMS; ++x)
+    for (uint32_t empty = state.board().emptyMask(); empty != 0; empty &= empty - 1)
     {
-        for (uint8_t y = 0; y < BOARD_DIMS; ++y)
+        const auto cell = static_cast<uint8_t>(__builtin_ctz(empty));
+        const auto x = static_cast<uint8_t>(cell % BOARD_DIMS);
+        const auto y = static_cast<uint8_t>(cell / BOARD_DIMS);
+        if (chanceMode_ == ChanceMode::FACTORED)
         {
-            if (state.board(x, y) == 0)
-            {
-                retval.push_back(std::make_pair(probabilityPerCell * PROBABILITY_SPAWN_2, ChanceEvent{x, y, 1}));
-                retval.push_back(std::make_pair(probabilityPerCell * PROBABILITY_SPAWN_4, ChanceEvent{x, y, 2}));
-            }
+            retval.push_back(std::make_pair(probabilityPerCell, ChanceEvent{x, y, 0}));
+            continue;
         }
+        retval.push_back(std::make_pair(probabilityPerCell * PROBABILITY_SPAWN_2, ChanceEvent{x, y, 1}));
+        retval.push_back(std::make_pair(probabilityPerCell * PROBABILITY_SPAWN_4, ChanceEvent{x, y, 2}));
     }
 
     return retval;
@@ -95,9 +107,16 @@ mcts::StageType G2048Problem::getNextStageType(const G2048State& state)
 ProblemDefinition::ValueVector G2048Problem::performChanceEvent(const ChanceEventType event, G2048State& state) const
 {
     assert(state.isChanceNext());
-    state.setNextChance(false);
     assert(state.board(event.x, event.y) == 0);
+    if (event.value == 0)
+    {
+        assert(state.spawnCell() == G2048State::NO_SPAWN_CELL);
+        state.setSpawnCell(static_cast<uint8_t>(BOARD_DIMS * event.y + event.x));
+        return {};
+    }
 
+    state.setNextChance(false);
+    state.setSpawnCell(G2048State::NO_SPAWN_CELL);
     state.setBoard(event.x, event.y, event.value);
 
     return {};
@@ -109,78 +128,28 @@ ProblemDefinition::ValueVector G2048Problem::performAction(const ActionType acti
 {
     assert(!state.isChanceNext());
 
-    ValueVector retval{0};
-
-    int start = 0;
-    int end = 0;
-    int increment = 1;
-    bool upDown = (action == UP || action == DOWN);
+    Board board = state.board();
+    uint32_t score = 0;
     switch (action)
     {
         case UP:
-            start = 0;
-            end = BOARD_DIMS;
+            score = board.moveUp();
             break;
         case LEFT:
-            start = 0;
-            end = BOARD_DIMS;
+            score = board.moveLeft();
             break;
         case RIGHT:
-            start = BOARD_DIMS - 1;
-            increment = -1;
-            end = -1;
+            score = board.moveRight();
             break;
         case DOWN:
-            start = BOARD_DIMS - 1;
-            increment = -1;
-            end = -1;
+            score = board.moveDown();
             break;
     }
-    size_t numUpdatedCells = 0;
-    for (size_t otherdim = 0; otherdim < BOARD_DIMS; otherdim++)
-    {
-        for (int xy = start; xy != end; xy += increment)
-        {
-            const size_t x = upDown ? otherdim : xy;
-            const size_t y = upDown ? xy : otherdim;
-            bool changed = false;
-            for (int xyd = xy + increment; xyd != end; xyd += increment)
-            {
-                const size_t xd = upDown ? otherdim : xyd;
-                const size_t yd = upDown ? xyd : otherdim;
-
-                if (state.board(xd, yd) == 0) { continue; }
-
-                if (state.board(x, y) == 0)
-                {
-                    state.setBoard(x, y, state.board(xd, yd));
-                    numUpdatedCells++;
-                    state.setBoard(xd, yd, 0);
-                    numUpdatedCells++;
-                    changed = true;
-                    break;
-                }
-                else if (state.board(x, y) == state.board(xd, yd))
-                {
-                    state.setBoard(x, y, state.board(x, y) + 1);
-                    numUpdatedCells++;
-                    retval += 1U << state.board(xd, yd);
-                    state.setBoard(xd, yd, 0);
-                    numUpdatedCells++;
-                    break;
-                }
-                else
-                {
-                    break;
-                }
-            }
-            if (changed) { xy -= increment; }
-        }
-    }
 
-    const bool didChangeAnyCell = numUpdatedCells > 0;
+    const bool didChangeAnyCell = board != state.board();
+    state.setBoard(board);
     state.setNextChance(didChangeAnyCell);
-    return retval;
+    return ValueVector(score);
 }
 
 ProblemDefinition::ValueVector G2048Problem::performRandomChanceEvent(G2048State& state) const
@@ -198,34 +167,7 @@ ProblemDefinition::ValueVector G2048Problem::performRandomAction(G2048State& sta
 
 [[nodiscard]] bool G2048Problem::isTerminal(const G2048State& state) const
 {
-    auto can = canMove(state);
-    return !state.isChanceNext() && !can.any();
-}
-
-G2048Problem::CanMove G2048Problem::canMove(const G2048State& state) const
-{
-    G2048Problem::CanMove retval{};
-    for (size_t x = 0; x < BOARD_DIMS; ++x)
-    {
-        for (size_t y = 0; y < BOARD_DIMS; ++y)
-        {
-            auto c = state.board(x, y);
-            if (x < BOARD_DIMS - 1)
-            {
-                auto cright = state.board(x + 1, y);
-                if (cright > 0 && (c == 0 || c == cright)) { retval.left = true; }
-                if (c > 0 && (cright == 0 || c == cright)) { retval.right = true; }
-            }
-            if (y < BOARD_DIMS - 1)
-            {
-                auto cbelow = state.board(x, y + 1);
-                if (cbelow > 0 && (c == 0 || c == cbelow)) { retval.up = true; }
-                if (c > 0 && (cbelow == 0 || c == cbelow)) { retval.down = true; }
-            }
-            if (retval.all()) { return retval; }
-        }
-    }
-    return retval;
+    return !state.isChanceNext() && state.board().legalMoves() == 0;
 }
 
 [[nodiscard]] size_t G2048Problem::countEmptyCells(const G2048State& state) const
@@ -240,27 +182,16 @@ void G2048Problem::addRandomElement(G2048State& state) const
     size_t numEmpty = countEmptyCells(state);
     assert(numEmpty > 0);
 
-    std::uniform_int_distribution<size_t> dist(0, numEmpty - 1);
-    size_t randNum = dist(engine_);
-
-    for (uint8_t x = 0; x < BOARD_DIMS; ++x)
+    auto& engine = engine_.get();
+    uint8_t cell = state.spawnCell();
+    if (cell == G2048State::NO_SPAWN_CELL)
     {
-        for (uint8_t y = 0; y < BOARD_DIMS; ++y)
-        {
-            if (state.board(x, y) != 0) { continue; }
-            if (randNum == 0)
-            {
-                if (bernoulli_(engine_)) { state.setBoard(x, y, 1); }
-                else
-                {
-                    state.setBoard(x, y, 2);
-                }
-                return;
-            }
-            randNum--;
-        }
+        std::uniform_int_distribution<size_t> dist(0, numEmpty - 1);
+        cell = state.board().emptyCell(dist(engine));
     }
-    assert(false);
+    state.setSpawnCell(G2048State::NO_SPAWN_CELL);
+    const bool spawnTwo = std::bernoulli_distribution{PROBABILITY_SPAWN_2}(engine);
+    state.setBoard(cell % BOARD_DIMS, cell / BOARD_DIMS, spawnTwo ? 1 : 2);
 }
 
 }  // namespace g2048
@@ -24,11 +24,13 @@
 
 #include "board.h"
 #include "mcts/problem.h"
+#include "mcts/random.h"
 #include "mcts/state.h"
 #include "zbo/max_size_vector.h"
 
 #include <array>
 #include <cassert>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <random>
@@ -50,7 +52,14 @@ struct ChanceEvent
 {
     uint8_t x;
     uint8_t y;
-    uint8_t value;  // 2 or 4
+    uint8_t value;  // exponent of the tile (1 -> 2, 2 -> 4) or 0 if only the cell is chosen (ChanceMode::FACTORED)
+};
+
+/// How the spawn of a new tile is represented as chance events
+enum class ChanceMode
+{
+    JOINT,    ///< one event for each empty cell and tile value
+    FACTORED  ///< one event for each empty cell, followed by a second chance stage with one event per tile value
 };
 
 class G2048Problem;
@@ -60,6 +69,8 @@ class G2048State : public mcts::State<G2048State>
   public:
     G2048State() : board_() { resetBoard(); }
 
+    static constexpr uint8_t NO_SPAWN_CELL = 0xFF;
+
     explicit G2048State(const Board& board, bool chance = false) : board_(board), nextIsChance_(chance) {}
     void resetBoard() { board_ = {}; }
 
@@ -69,17 +80,23 @@ class G2048State : public mcts::State<G2048State>
     [[nodiscard]] bool empty(size_t x, size_t y) const;
 
     void setBoard(size_t x, size_t y, uint8_t value) { board_.set(x, y, value); }
+    void setBoard(const Board& board) { board_ = board; }
 
     [[nodiscard]] const Board& board() const { return board_; }
     [[nodiscard]] bool isChanceNext() const { return nextIsChance_; }
     void setNextChance(bool isChance) { nextIsChance_ = isChance; }
 
+    /// cell (BOARD_DIMS * y + x) of the next tile if it is chosen and its value is not (ChanceMode::FACTORED)
+    [[nodiscard]] uint8_t spawnCell() const { return spawnCell_; }
+    void setSpawnCell(uint8_t cell) { spawnCell_ = cell; }
+
     [[nodiscard]] bool operator==(const G2048State& rhs) const;
     [[nodiscard]] bool operator!=(const G2048State& rhs) const;
 
   private:
     Board board_{};
     bool nextIsChance_ = true;
+    uint8_t spawnCell_ = NO_SPAWN_CELL;
 };
 
 struct ProblemDefinition
@@ -101,7 +118,7 @@ class G2048Problem : public mcts::Problem<G2048Problem, ProblemDefinition>
 {
   public:
     G2048Problem() = default;
-    G2048Problem(size_t seed) : engine_(seed) {}
+    G2048Problem(size_t seed, ChanceMode chanceMode = ChanceMode::JOINT) : engine_(seed), chanceMode_(chanceMode) {}
     std::string actionToString(const StateType& state, const ActionType& action) const;  // NOLINT
 
     static mcts::StageType getNextStageType(const G2048State& state);
@@ -118,24 +135,29 @@ class G2048Problem : public mcts::Problem<G2048Problem, ProblemDefinition>
 
     [[nodiscard]] bool isTerminal(const G2048State& state) const;
 
+    [[nodiscard]] ChanceMode chanceMode() const { return chanceMode_; }
+
   private:
-    struct CanMove
-    {
-        bool left{false};
-        bool right{false};
-        bool up{false};
-        bool down{false};
-        [[nodiscard]] bool any() const { return left || right || up || down; }
-        [[nodiscard]] bool all() const { return left && right && up && down; }
-    };
-
-    [[nodiscard]] CanMove canMove(const G2048State& state) const;
     [[nodiscard]] size_t countEmptyCells(const G2048State& state) const;
 
     void addRandomElement(G2048State& state) const;
 
   private:
-    mutable std::minstd_rand0 engine_{};
-    mutable std::bernoulli_distribution bernoulli_{PROBABILITY_SPAWN_2};
+    /// separate engine per thread, so that one problem can be used by several threads at once
+    mcts::ThreadLocalEngine engine_{};
+    ChanceMode chanceMode_{ChanceMode::JOINT};
+};
+}  // namespace g2048
+/// Makes the states usable as keys of the afterstates of the solver (see mcts::Solver::Parameter::shareAfterstates)
+namespace std {
+template <>
+struct hash<g2048::G2048State>
+{
+    size_t operator()(const g2048::G2048State& state) const noexcept
+    {
+        constexpr uint32_t SPAWN_CELL_SHIFT = 8;
+        return mcts::splitMix64(state.board().raw() ^ uint64_t(state.isChanceNext()) ^
+                                (uint64_t(state.spawnCell()) << SPAWN_CELL_SHIFT));
+    }
 };
-}  // namespace g2048
\ No newline at end of file
+}  // namespace std
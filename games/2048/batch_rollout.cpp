@@ -0,0 +1,311 @@
+#include "batch_rollout.h"
+
+// functions passing vector types are internal to this file, so their ABI may depend on the enabled instruction set
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#include "board_bits.h"
+#include "mcts/random.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace g2048 {
+
+namespace {
+
+constexpr size_t LANES = BatchRolloutPolicy::LANES;
+constexpr uint64_t SPAWN_2_THRESHOLD = uint64_t(PROBABILITY_SPAWN_2 * (1U << 16U));
+constexpr uint64_t RANDOM_16_MASK = 0xFFFFU;
+constexpr uint64_t SCORE_MASK = 0xFFFFFFFFU;
+
+using Lanes = uint64_t __attribute__((vector_size(LANES * sizeof(uint64_t))));
+using FloatLanes = float __attribute__((vector_size(LANES * sizeof(float))));
+
+template <typename T>
+inline T xorShift(T x)
+{
+    x ^= x << 13U;
+    x ^= x >> 7U;
+    x ^= x << 17U;
+    return x;
+}
+
+/// random number in [0, n) from the upper 32 bit of the random state
+template <typename T>
+inline T randomBelow(T random, T n)
+{
+    return ((random >> 32U) * n) >> 32U;
+}
+
+/// exponent of the spawned tile (1 -> 2 or 2 -> 4) from the lower 16 bit of the random state
+inline uint8_t spawnExponent(uint64_t random)
+{
+    return (random & RANDOM_16_MASK) < SPAWN_2_THRESHOLD ? 1 : 2;
+}
+
+/// Board a rollout starts from. If the cell of the next tile is already chosen (ChanceMode::FACTORED), the tile is
+/// spawned there with a value from the seed, and the rollout continues with a move
+inline Board startBoard(const G2048State& state, uint64_t seed, bool& chance)
+{
+    Board board = state.board();
+    chance = state.isChanceNext();
+    if (chance && state.spawnCell() != G2048State::NO_SPAWN_CELL)
+    {
+        board.set(state.spawnCell() % BOARD_DIMS, state.spawnCell() / BOARD_DIMS, spawnExponent(seed));
+        chance = false;
+    }
+    return board;
+}
+
+/// 1 if a >= b else 0, for a, b < 2^63
+inline Lanes notLess(Lanes a, Lanes b)
+{
+    return 1U - ((a - b) >> 63U);
+}
+
+inline bool any(Lanes x)
+{
+    uint64_t retval = 0;
+    for (size_t lane = 0; lane < LANES; ++lane) { retval |= x[lane]; }
+    return retval != 0;
+}
+
+inline Lanes select(Lanes condition, Lanes ifTrue, Lanes ifFalse)
+{
+    const Lanes mask = Lanes{} - condition;
+    return (ifTrue & mask) | (ifFalse & ~mask);
+}
+
+/// rows[index] and scores[index] for all lanes
+inline void gather(const bits::MoveTables& tables, Lanes index, Lanes& rows, Lanes& scores)
+{
+#if defined(__AVX512F__)
+    // 64 bit gathers of the 16/32 bit entries, the upper bits belong to the next entries and are masked out. The
+    // masked gather with all lanes enabled avoids reading an undefined source register
+    constexpr __mmask8 ALL_LANES = 0xFF;
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i idx{};
+    std::memcpy(&idx, &index, sizeof(idx));
+    const __m512i gatheredRows = _mm512_mask_i64gather_epi64(zero, ALL_LANES, idx, tables.rows.data(), 2);
+    const __m512i gatheredScores = _mm512_mask_i64gather_epi64(zero, ALL_LANES, idx, tables.scores.data(), 4);
+    std::memcpy(&rows, &gatheredRows, sizeof(rows));
+    std::memcpy(&scores, &gatheredScores, sizeof(scores));
+    rows &= bits::ROW_MASK;
+    scores &= SCORE_MASK;
+#elif defined(__AVX2__)
+    constexpr size_t HALF = LANES / 2;
+    static_assert(sizeof(__m256i) == HALF * sizeof(uint64_t));
+    const auto* rowBase = reinterpret_cast<const long long*>(tables.rows.data());      // NOLINT
+    const auto* scoreBase = reinterpret_cast<const long long*>(tables.scores.data());  // NOLINT
+    for (size_t half = 0; half < 2; ++half)
+    {
+        __m256i idx{};
+        std::memcpy(&idx, reinterpret_cast<const uint64_t*>(&index) + half * HALF, sizeof(idx));
+        const __m256i gatheredRows = _mm256_i64gather_epi64(rowBase, idx, 2);
+        const __m256i gatheredScores = _mm256_i64gather_epi64(scoreBase, idx, 4);
+        std::memcpy(reinterpret_cast<uint64_t*>(&rows) + half * HALF, &gatheredRows, sizeof(gatheredRows));
+        std::memcpy(reinterpret_cast<uint64_t*>(&scores) + half * HALF, &gatheredScores, sizeof(gatheredScores));
+    }
+    rows &= bits::ROW_MASK;
+    scores &= SCORE_MASK;
+#else
+    for (size_t lane = 0; lane < LANES; ++lane)
+    {
+        rows[lane] = tables.rows[index[lane]];
+        scores[lane] = tables.scores[index[lane]];
+    }
+#endif
+}
+
+/// Places a 2 or 4 on a random empty cell of every board. The n-th empty cell is found with a prefix sum over the
+/// empty nibbles instead of a search: the nibble with prefix count n + 1 that is empty itself
+inline Lanes spawnTile(Lanes board, Lanes random)
+{
+    const Lanes empty = bits::emptyNibbles(board);
+    // nibble i is the number of empty cells in [0, i], only the last nibble can overflow (16 empty cells)
+    const Lanes prefix = empty * bits::NIBBLE_LSB;
+    Lanes numEmpty = prefix >> 60U;
+    numEmpty += (1U - bits::nonZero(numEmpty)) * 16U;  // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+
+    const Lanes n = randomBelow(random, numEmpty);
+    const Lanes target = bits::emptyNibbles(prefix ^ (((n + 1U) & bits::NIBBLE_MASK) * bits::NIBBLE_LSB)) & empty;
+    const Lanes exponent = 2U - (((random & RANDOM_16_MASK) - SPAWN_2_THRESHOLD) >> 63U);
+    return board | (target * exponent);
+}
+
+/// Performs a random legal move on every board and returns the score of it
+inline Lanes moveRandom(Lanes& board, Lanes legal, Lanes random)
+{
+    // choose the r-th legal action in the order of Actions (UP, LEFT, RIGHT, DOWN)
+    const Lanes c0 = legal & 1U;
+    const Lanes c1 = c0 + ((legal >> 1U) & 1U);
+    const Lanes c2 = c1 + ((legal >> 2U) & 1U);
+    const Lanes c3 = c2 + ((legal >> 3U) & 1U);
+    const Lanes r = randomBelow(random, c3);
+    const Lanes action = notLess(r, c0) + notLess(r, c1) + notLess(r, c2);
+
+    // up and down are left and right on the transposed board
+    const Lanes vertical = 1U - bits::nonZero(action * (3U - action));
+    const Lanes rightward = action >> 1U;
+    const Lanes source = select(vertical, bits::transpose(board), board);
+    const Lanes offset = rightward * bits::MoveTables::RIGHT;
+
+    const auto& tables = bits::moveTables();
+    Lanes moved{};
+    Lanes score{};
+    for (uint32_t y = 0; y < BOARD_DIMS; ++y)
+    {
+        Lanes rows{};
+        Lanes scores{};
+        gather(tables, ((source >> (bits::BITS_PER_ROW * y)) & bits::ROW_MASK) + offset, rows, scores);
+        moved |= rows << (bits::BITS_PER_ROW * y);
+        score += scores;
+    }
+    board = select(vertical, bits::transpose(moved), moved);
+    return score;
+}
+
+/// Scalar rollout on top of the Board interface with the same random decisions as the vectorized one
+float scalarRollout(const G2048State& state, uint64_t random, size_t maxDepth, float discount)
+{
+    bool chance = false;
+    Board board = startBoard(state, random, chance);
+    float value = 0;
+    float currDiscount = 1;
+    size_t depth = 0;
+    while (chance || board.legalMoves() != 0)
+    {
+        random = xorShift(random);
+        if (chance)
+        {
+            const uint64_t n = randomBelow<uint64_t>(random, board.numEmpty());
+            const uint8_t cell = board.emptyCell(n);
+            board.set(cell % BOARD_DIMS, cell / BOARD_DIMS, spawnExponent(random));
+        }
+        else
+        {
+            uint64_t legal = board.legalMoves();
+            const uint64_t r = randomBelow<uint64_t>(random, __builtin_popcountll(legal));
+            for (uint64_t i = 0; i < r; ++i) { legal &= legal - 1; }
+            uint32_t score = 0;
+            switch (static_cast<Actions>(__builtin_ctzll(legal)))
+            {
+                case UP:
+                    score = board.moveUp();
+                    break;
+                case LEFT:
+                    score = board.moveLeft();
+                    break;
+                case RIGHT:
+                    score = board.moveRight();
+                    break;
+                case DOWN:
+                    score = board.moveDown();
+                    break;
+            }
+            value += currDiscount * float(score);
+        }
+        chance = !chance;
+        depth++;
+        currDiscount *= discount;
+        if (depth > maxDepth) { break; }
+    }
+    return value;
+}
+
+}  // namespace
+
+uint64_t BatchRolloutPolicy::nextRolloutSeed()
+{
+    // xorshift must not start with 0
+    return mcts::splitMix64(seed_ + numRollouts_++) | 1U;
+}
+
+float BatchRolloutPolicy::rollout(const G2048State& state, [[maybe_unused]] const G2048Problem& problem)
+{
+    return scalarRollout(state, nextRolloutSeed(), rolloutDepth_, discount_);
+}
+
+void BatchRolloutPolicy::rolloutBatch(const G2048State* const* states, size_t count,
+                                      [[maybe_unused]] const G2048Problem& problem, float* values)
+{
+    Lanes board{};
+    Lanes random{};
+    Lanes chance{};
+    Lanes active{};
+    Lanes depth{};
+    FloatLanes value{};
+    FloatLanes currDiscount{};
+    std::array<size_t, LANES> stateIndex{};
+
+    size_t nextState = 0;
+    const auto load = [&](size_t lane) {
+        if (nextState == count)
+        {
+            active[lane] = 0;
+            return;
+        }
+        const G2048State& state = *states[nextState];
+        random[lane] = nextRolloutSeed();
+        bool laneChance = false;
+        board[lane] = startBoard(state, random[lane], laneChance).raw();
+        chance[lane] = laneChance ? 1 : 0;
+        active[lane] = 1;
+        depth[lane] = 0;
+        value[lane] = 0;
+        currDiscount[lane] = 1;
+        stateIndex.at(lane) = nextState++;
+    };
+    for (size_t lane = 0; lane < LANES; ++lane) { load(lane); }
+
+    // lanes that are done after this step are written back and refilled before the next step
+    const auto finish = [&](Lanes done) {
+        for (size_t lane = 0; lane < LANES; ++lane)
+        {
+            if (done[lane] == 0) { continue; }
+            values[stateIndex.at(lane)] = value[lane];
+            load(lane);
+        }
+    };
+
+    // keeps notLess valid and avoids the overflow of the default depth
+    const uint64_t maxDepth = std::min<uint64_t>(rolloutDepth_, std::numeric_limits<uint32_t>::max());
+
+    while (any(active))
+    {
+        // terminal boards are finished before doing a step, refilled lanes might be terminal as well
+        Lanes legal = bits::legalMoves(board);
+        for (Lanes done = active & (1U - chance) & (1U - bits::nonZero(legal)); any(done);
+             done = active & (1U - chance) & (1U - bits::nonZero(legal)))
+        {
+            finish(done);
+            legal = bits::legalMoves(board);
+        }
+        if (!any(active)) { break; }
+
+        random = select(active, xorShift(random), random);
+        Lanes afterMove = board;
+        const Lanes score = moveRandom(afterMove, legal, random);
+        const Lanes afterSpawn = spawnTile(board, random);
+        board = select(active, select(chance, afterSpawn, afterMove), board);
+
+        const Lanes rewarded = active & (1U - chance);
+        value += currDiscount * __builtin_convertvector(score * rewarded, FloatLanes);
+        currDiscount *= __builtin_convertvector(select(active, Lanes{} + 1U, Lanes{}), FloatLanes) * (discount_ - 1) +
+                        1;
+        chance ^= active;
+        depth += active;
+
+        const Lanes tooDeep = active & notLess(depth, Lanes{} + (maxDepth + 1));
+        if (any(tooDeep)) { finish(tooDeep); }
+    }
+}
+
+}  // namespace g2048
@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "2048.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace g2048 {
+
+/**
+ * @brief Random rollouts for 2048 that advance LANES boards in lock step using GCC vector extensions. With AVX2 or
+ * AVX-512 the move tables are read with gather instructions, otherwise the compiler falls back to scalar code.
+ * Finished lanes are refilled with the next state, so all lanes stay busy.
+ *
+ * Every rollout draws from its own xorshift generator, seeded from the policy seed and a running rollout counter.
+ * Hence a batch of rollouts produces exactly the values of the same number of single rollouts with the same seed.
+ */
+class BatchRolloutPolicy
+{
+  public:
+    static constexpr size_t LANES = 8;
+
+    BatchRolloutPolicy() = default;
+    explicit BatchRolloutPolicy(size_t depth, float discount = 1.0f, uint64_t seed = std::random_device{}())
+        : rolloutDepth_(depth), discount_(discount), seed_(seed)
+    {
+    }
+
+    /// Rollout of a single state, see rolloutBatch for several states at once
+    float rollout(const G2048State& state, const G2048Problem& problem);
+
+    /// Rollout of count states, the values are written to values[0, count). The solver uses this to evaluate all
+    /// children of an expansion at once
+    void rolloutBatch(const G2048State* const* states, size_t count, const G2048Problem& problem, float* values);
+
+    void seed(uint64_t seed)
+    {
+        seed_ = seed;
+        numRollouts_ = 0;
+    }
+
+  private:
+    [[nodiscard]] uint64_t nextRolloutSeed();
+
+    size_t rolloutDepth_{std::numeric_limits<size_t>::max()};
+    float discount_{1.0f};
+    uint64_t seed_{std::random_device{}()};
+    uint64_t numRollouts_{0};
+};
+}  // namespace g2048
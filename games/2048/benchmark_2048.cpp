@@ -0,0 +1,130 @@
+#include "2048.h"
+#include "mcts/selection/ucb1.h"
+#include "mcts/solver.h"
+#include "policies.h"
+#include "zbo/stop_watch.h"
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace mcts;
+
+using G2048RolloutPolicy = mcts::RolloutPolicy<g2048::FixedSequencePolicy>;
+using G2048Solver = mcts::Solver<g2048::G2048Problem, UCB1SelectionPolicy<float>, G2048RolloutPolicy>;
+
+constexpr size_t NUM_POSITIONS = 30;
+constexpr size_t MOVES_BETWEEN_POSITIONS = 10;
+constexpr size_t REFERENCE_ITERATIONS = 10000;
+constexpr size_t NUM_REPETITIONS = 10;
+constexpr std::array<size_t, 3> ITERATIONS = {100, 200, 500};
+
+G2048Solver makeSolver(size_t numIterations, RootStrategy strategy)
+{
+    UCB1SelectionPolicy<float> selectionPolicy({0, 500, 5});  // NOLINT
+    G2048Solver solver(std::move(selectionPolicy), G2048RolloutPolicy{100});  // NOLINT
+    solver.parameter().numIterations = numIterations;
+    solver.parameter().rootStrategy = strategy;
+    return solver;
+}
+
+/// Samples decision positions along games played with the BestPositionPolicy
+std::vector<g2048::G2048State> generatePositions(const g2048::G2048Problem& problem)
+{
+    std::vector<g2048::G2048State> positions;
+    g2048::BestPositionPolicy policy{};
+    while (positions.size() < NUM_POSITIONS)
+    {
+        g2048::G2048State state;
+        size_t numMoves = 0;
+        while (!problem.isTerminal(state) && positions.size() < NUM_POSITIONS)
+        {
+            if (problem.getNextStageType(state) == StageType::CHANCE)
+            {
+                problem.performRandomChanceEvent(state);
+                continue;
+            }
+            if (++numMoves % MOVES_BETWEEN_POSITIONS == 0) { positions.push_back(state); }
+            problem.performAction(policy.getAction(state, problem), state);
+        }
+    }
+    return positions;
+}
+
+/// Mean value of every root action after a long search, used as ground truth for the move quality
+struct Reference
+{
+    std::map<g2048::Actions, float> values;
+    float best{std::numeric_limits<float>::lowest()};
+};
+
+Reference computeReference(const g2048::G2048Problem& problem, const g2048::G2048State& state)
+{
+    auto solver = makeSolver(REFERENCE_ITERATIONS, RootStrategy::SELECTION_POLICY);
+    (void)solver.run(problem, state);
+
+    Reference reference{};
+    for (const auto& [action, stat] : solver.getTopLevelUtilities())
+    {
+        reference.values[action] = stat.value();
+        reference.best = std::max(reference.best, stat.value());
+    }
+    return reference;
+}
+
+void benchmarkRootStrategy(const std::string& name, RootStrategy strategy, const g2048::G2048Problem& problem,
+                           const std::vector<g2048::G2048State>& positions, const std::vector<Reference>& references)
+{
+    for (const size_t iterations : ITERATIONS)
+    {
+        auto solver = makeSolver(iterations, strategy);
+
+        double regret = 0;
+        size_t numOptimal = 0;
+        size_t numMoves = 0;
+        zbo::StopWatch watch;
+        watch.start();
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            for (size_t rep = 0; rep < NUM_REPETITIONS; ++rep)
+            {
+                const auto action = solver.run(problem, positions[i]);
+                const float value = references[i].values.at(action);
+                regret += references[i].best - value;
+                numOptimal += value == references[i].best ? 1 : 0;
+                numMoves++;
+            }
+        }
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(watch.stop());
+
+        constexpr int NAME_WIDTH = 20;
+        constexpr int PERCENT = 100;
+        std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::setw(6) << iterations
+                  << " iterations: mean regret " << std::setw(8) << std::fixed << std::setprecision(3)
+                  << regret / double(numMoves) << ", optimal moves " << std::setw(6) << std::setprecision(1)
+                  << double(numOptimal) / double(numMoves) * PERCENT << "%, " << std::setw(8)
+                  << double(duration.count()) / double(numMoves) << "us/move\n";
+    }
+}
+
+int main(int, char**)
+{
+    constexpr size_t SEED = 42;
+    g2048::G2048Problem problem(SEED);
+
+    std::cout << "Generating " << NUM_POSITIONS << " positions with reference values from " << REFERENCE_ITERATIONS
+              << " iterations" << std::endl;
+    const auto positions = generatePositions(problem);
+    std::vector<Reference> references;
+    for (const auto& position : positions) { references.push_back(computeReference(problem, position)); }
+
+    std::cout << "#### Move quality per iteration of the root strategies: " << std::endl;
+    benchmarkRootStrategy("UCB1", RootStrategy::SELECTION_POLICY, problem, positions, references);
+    benchmarkRootStrategy("SequentialHalving", RootStrategy::SEQUENTIAL_HALVING, problem, positions, references);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "2048.h"
+#include "batch_rollout.h"
+#include "mcts/rollout/random_rollout.h"
+#include "zbo/stop_watch.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+constexpr size_t NUM_STATES = 32;
+constexpr size_t NUM_REPETITIONS = 500;
+
+/// States after one random move from a sample of positions, like the children of an expansion
+std::vector<g2048::G2048State> generateStates(const g2048::G2048Problem& problem)
+{
+    std::vector<g2048::G2048State> states;
+    g2048::G2048State state;
+    while (states.size() < NUM_STATES)
+    {
+        if (problem.isTerminal(state)) { state = g2048::G2048State{}; }
+        if (problem.getNextStageType(state) == mcts::StageType::CHANCE)
+        {
+            problem.performRandomChanceEvent(state);
+            continue;
+        }
+        problem.performRandomAction(state);
+        states.push_back(state);
+    }
+    return states;
+}
+
+template <typename Function>
+void benchmark(const std::string& name, Function&& rolloutAll)
+{
+    float sum = 0;
+    zbo::StopWatch watch;
+    watch.start();
+    for (size_t rep = 0; rep < NUM_REPETITIONS; ++rep) { sum += rolloutAll(); }
+    const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(watch.stop());
+
+    const double rolloutsPerSecond = double(NUM_REPETITIONS * NUM_STATES) / duration.count();
+    constexpr int NAME_WIDTH = 20;
+    std::cout << std::setw(NAME_WIDTH) << name << ": " << std::fixed << std::setprecision(0) << rolloutsPerSecond
+              << " rollouts/s, mean value " << std::setprecision(1) << sum / (NUM_REPETITIONS * NUM_STATES) << "\n";
+}
+
+int main(int, char**)
+{
+    constexpr size_t SEED = 42;
+    g2048::G2048Problem problem(SEED);
+    const auto states = generateStates(problem);
+
+    mcts::RandomRolloutPolicy randomPolicy{};
+    benchmark("RandomRolloutPolicy", [&]() {
+        float sum = 0;
+        for (const auto& state : states) { sum += randomPolicy.rollout(state, problem); }
+        return sum;
+    });
+
+    g2048::BatchRolloutPolicy singlePolicy(std::numeric_limits<size_t>::max(), 1.0f, SEED);
+    benchmark("single rollout", [&]() {
+        float sum = 0;
+        for (const auto& state : states) { sum += singlePolicy.rollout(state, problem); }
+        return sum;
+    });
+
+    g2048::BatchRolloutPolicy batchPolicy(std::numeric_limits<size_t>::max(), 1.0f, SEED);
+    std::vector<const g2048::G2048State*> statePointers;
+    for (const auto& state : states) { statePointers.push_back(&state); }
+    std::vector<float> values(states.size());
+    benchmark("batch rollout", [&]() {
+        batchPolicy.rolloutBatch(statePointers.data(), statePointers.size(), problem, values.data());
+        float sum = 0;
+        for (float value : values) { sum += value; }
+        return sum;
+    });
+    return 0;
+}
@@ -1,24 +1,91 @@
 #include "board.h"
 
+#include "board_bits.h"
+
+#include <algorithm>
+#include <cassert>
 #include <iomanip>
+#include <memory>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
 
 namespace g2048 {
 
-// TODO for a better bit level magic, look at https://github.com/nneonneo/2048-ai/blob/master/2048.cpp
+using bits::BITS_PER_NIBBLE;
+using bits::BITS_PER_ROW;
+using bits::NIBBLE_MASK;
+using bits::NUM_ROWS;
+
+inline uint16_t reverseRow(uint16_t row)
+{
+    return static_cast<uint16_t>((row >> 12U) | ((row >> 4U) & 0x00F0U) | ((row << 4U) & 0x0F00U) | (row << 12U));
+}
+
+std::unique_ptr<bits::MoveTables> createMoveTables()
+{
+    auto tables = std::make_unique<bits::MoveTables>();
+    for (size_t row = 0; row < NUM_ROWS; ++row)
+    {
+        std::array<uint8_t, BOARD_DIMS> cells{};
+        size_t numCells = 0;
+        uint32_t score = 0;
+        uint8_t pending = 0;  // last tile that did not merge yet
+        for (uint32_t x = 0; x < BOARD_DIMS; ++x)
+        {
+            const auto cell = static_cast<uint8_t>((row >> (BITS_PER_NIBBLE * x)) & NIBBLE_MASK);
+            if (cell == 0) { continue; }
+            // a merge of two 32768 tiles cannot be represented in a nibble, so they don't merge
+            if (cell == pending && cell < NIBBLE_MASK)
+            {
+                cells.at(numCells++) = cell + 1;
+                score += 1U << cell;
+                pending = 0;
+            }
+            else
+            {
+                if (pending != 0) { cells.at(numCells++) = pending; }
+                pending = cell;
+            }
+        }
+        if (pending != 0) { cells.at(numCells++) = pending; }
+
+        uint16_t result = 0;
+        for (uint32_t x = 0; x < numCells; ++x) { result |= uint16_t(cells.at(x)) << (BITS_PER_NIBBLE * x); }
+
+        tables->rows.at(bits::MoveTables::LEFT + row) = result;
+        tables->scores.at(bits::MoveTables::LEFT + row) = score;
+        // moving right is moving the reversed row left
+        const uint16_t reversed = reverseRow(static_cast<uint16_t>(row));
+        tables->rows.at(bits::MoveTables::RIGHT + reversed) = reverseRow(result);
+        tables->scores.at(bits::MoveTables::RIGHT + reversed) = score;
+    }
+    return tables;
+}
 
-constexpr uint8_t NIBBLE_MASK = 0xFU;
-constexpr uint32_t BITS_PER_NIBBLE = 4;
+namespace bits {
+const MoveTables& moveTables()
+{
+    static const std::unique_ptr<MoveTables> TABLES = createMoveTables();
+    return *TABLES;
+}
+}  // namespace bits
 
-inline uint64_t transpose(uint64_t x)
+/// Applies the row table (left or right) to all rows of the board and sums up the score
+inline uint32_t moveRows(uint64_t& values, size_t direction)
 {
-    uint64_t a1 = x & 0xF0F00F0FF0F00F0FULL;
-    uint64_t a2 = x & 0x0000F0F00000F0F0ULL;
-    uint64_t a3 = x & 0x0F0F00000F0F0000ULL;
-    uint64_t a = a1 | (a2 << 12) | (a3 >> 12);
-    uint64_t b1 = a & 0xFF00FF0000FF00FFULL;
-    uint64_t b2 = a & 0x00FF00FF00000000ULL;
-    uint64_t b3 = a & 0x00000000FF00FF00ULL;
-    return b1 | (b2 >> 24) | (b3 << 24);
+    const auto& tables = bits::moveTables();
+    uint64_t result = 0;
+    uint32_t score = 0;
+    for (uint32_t y = 0; y < BOARD_DIMS; ++y)
+    {
+        const size_t row = direction + ((values >> (BITS_PER_ROW * y)) & bits::ROW_MASK);
+        result |= uint64_t(tables.rows[row]) << (BITS_PER_ROW * y);
+        score += tables.scores[row];
+    }
+    values = result;
+    return score;
 }
 
 uint32_t position(size_t x, size_t y)
@@ -33,7 +100,47 @@ uint32_t shift(size_t x, size_t y)
 
 void Board::transpose()
 {
-    values_ = g2048::transpose(values_);
+    values_ = bits::transpose(values_);
+}
+
+Board Board::canonical() const
+{
+    const auto symmetries = bits::symmetries(values_);
+    Board board{};
+    board.values_ = *std::min_element(symmetries.begin(), symmetries.end());
+    return board;
+}
+
+uint32_t Board::moveLeft()
+{
+    return moveRows(values_, bits::MoveTables::LEFT);
+}
+
+uint32_t Board::moveRight()
+{
+    return moveRows(values_, bits::MoveTables::RIGHT);
+}
+
+uint32_t Board::moveUp()
+{
+    // columns become rows in the transposed board, so up is left and down is right
+    values_ = bits::transpose(values_);
+    const uint32_t score = moveRows(values_, bits::MoveTables::LEFT);
+    values_ = bits::transpose(values_);
+    return score;
+}
+
+uint32_t Board::moveDown()
+{
+    values_ = bits::transpose(values_);
+    const uint32_t score = moveRows(values_, bits::MoveTables::RIGHT);
+    values_ = bits::transpose(values_);
+    return score;
+}
+
+uint8_t Board::legalMoves() const
+{
+    return static_cast<uint8_t>(bits::legalMoves(values_));
 }
 
 size_t Board::numEmpty() const
@@ -54,6 +161,36 @@ size_t Board::numEmpty() const
     x += x >> 4U;  // this can overflow to the next nibble if there were 16 empty positions
     return x & 0xfU;
 }
+
+uint16_t Board::emptyMask() const
+{
+    auto x = bits::emptyNibbles(values_);
+#ifdef __BMI2__
+    return static_cast<uint16_t>(_pext_u64(x, bits::NIBBLE_LSB));
+#else
+    // gather the bits in the lowest 16 bit by doubling the number of adjacent bits in every step
+    x = (x | (x >> 3U)) & 0x0303030303030303ULL;
+    x = (x | (x >> 6U)) & 0x000F000F000F000FULL;
+    x = (x | (x >> 12U)) & 0x000000FF000000FFULL;
+    x = (x | (x >> 24U)) & 0xFFFFULL;
+    return static_cast<uint16_t>(x);
+#endif
+}
+
+uint8_t Board::emptyCell(size_t n) const
+{
+    assert(n < numEmpty());
+    const uint32_t mask = emptyMask();
+#ifdef __BMI2__
+    // deposit a single bit at the position of the n-th set bit of the mask
+    return static_cast<uint8_t>(__builtin_ctz(_pdep_u32(1U << n, mask)));
+#else
+    uint32_t remaining = mask;
+    for (; n > 0; --n) { remaining &= remaining - 1; }  // clear lowest set bit
+    return static_cast<uint8_t>(__builtin_ctz(remaining));
+#endif
+}
+
 uint8_t Board::biggestExp() const
 {
     uint8_t max = 0;
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <ostream>
 
 namespace g2048 {
@@ -30,6 +31,15 @@ namespace g2048 {
 constexpr size_t BOARD_DIMS = 4;
 constexpr size_t NUM_CELLS = BOARD_DIMS * BOARD_DIMS;
 
+/// Bits of Board::legalMoves(), one per direction in the order of g2048::Actions
+enum MoveMask : uint8_t
+{
+    MOVE_UP = 1U << 0U,
+    MOVE_LEFT = 1U << 1U,
+    MOVE_RIGHT = 1U << 2U,
+    MOVE_DOWN = 1U << 3U
+};
+
 struct Board
 {
     Board() = default;
@@ -39,12 +49,34 @@ struct Board
     void set(size_t x, size_t y, uint8_t value);
     void transpose();
 
+    /// Move all tiles to the left (towards x = 0), merging equal neighbours once. Returns the score of the move, which
+    /// is the sum of 2^exponent of all tiles that were merged
+    uint32_t moveLeft();
+    /// Move all tiles to the right (towards x = BOARD_DIMS - 1). Returns the score of the move
+    uint32_t moveRight();
+    /// Move all tiles up (towards y = 0). Returns the score of the move
+    uint32_t moveUp();
+    /// Move all tiles down (towards y = BOARD_DIMS - 1). Returns the score of the move
+    uint32_t moveDown();
+
+    /// Mask of all directions (MoveMask) in which at least one tile can move or merge
+    [[nodiscard]] uint8_t legalMoves() const;
+
     bool operator==(const Board& other) const { return values_ == other.values_; }
+    bool operator!=(const Board& other) const { return values_ != other.values_; }
 
     [[nodiscard]] size_t numEmpty() const;
+    /// Bit i is set if the cell i = BOARD_DIMS * y + x is empty
+    [[nodiscard]] uint16_t emptyMask() const;
+    /// Index (BOARD_DIMS * y + x) of the n-th empty cell, counted in the order of the cell indices. n < numEmpty()
+    [[nodiscard]] uint8_t emptyCell(size_t n) const;
     [[nodiscard]] size_t biggestTile() const;
     [[nodiscard]] uint8_t biggestExp() const;
 
+    /// Representative of the 8 rotations and reflections of the board (the one with the smallest raw value). Boards that
+    /// are symmetric to each other have the same canonical board and, as 2048 is symmetric, the same game value
+    [[nodiscard]] Board canonical() const;
+
     [[nodiscard]] uint64_t raw() const { return values_; }
     friend std::ostream& operator<<(std::ostream& os, const Board& board);
 
@@ -0,0 +1,151 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "board.h"
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Bit level operations on the packed board (one nibble per cell, row y in bits [16 y, 16 y + 16)). All functions are
+ * templates, so that they work on a single uint64_t as well as on GCC vector types holding several boards at once
+ */
+namespace g2048::bits {
+
+constexpr uint8_t NIBBLE_MASK = 0xFU;
+constexpr uint32_t BITS_PER_NIBBLE = 4;
+constexpr uint32_t BITS_PER_ROW = BITS_PER_NIBBLE * BOARD_DIMS;
+constexpr uint64_t ROW_MASK = 0xFFFFULL;
+constexpr size_t NUM_ROWS = 1U << BITS_PER_ROW;
+/// lowest bit of every nibble
+constexpr uint64_t NIBBLE_LSB = 0x1111111111111111ULL;
+
+template <typename T>
+inline T transpose(T x)
+{
+    T a1 = x & 0xF0F00F0FF0F00F0FULL;
+    T a2 = x & 0x0000F0F00000F0F0ULL;
+    T a3 = x & 0x0F0F00000F0F0000ULL;
+    T a = a1 | (a2 << 12U) | (a3 >> 12U);
+    T b1 = a & 0xFF00FF0000FF00FFULL;
+    T b2 = a & 0x00FF00FF00000000ULL;
+    T b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24U) | (b3 << 24U);
+}
+
+/// mirror the board at its vertical axis, x -> BOARD_DIMS - 1 - x
+template <typename T>
+inline T mirrorHorizontal(T x)
+{
+    return ((x & 0x000F000F000F000FULL) << 12U) | ((x & 0x00F000F000F000F0ULL) << 4U) |
+           ((x & 0x0F000F000F000F00ULL) >> 4U) | ((x & 0xF000F000F000F000ULL) >> 12U);
+}
+
+/// mirror the board at its horizontal axis, y -> BOARD_DIMS - 1 - y
+template <typename T>
+inline T mirrorVertical(T x)
+{
+    return (x << 48U) | ((x & 0xFFFF0000ULL) << 16U) | ((x >> 16U) & 0xFFFF0000ULL) | (x >> 48U);
+}
+
+constexpr size_t NUM_SYMMETRIES = 8;
+
+/// all rotations and reflections of the board, the first one is the board itself
+template <typename T>
+inline std::array<T, NUM_SYMMETRIES> symmetries(T x)
+{
+    const T transposed = transpose(x);
+    const T mirrored = mirrorHorizontal(x);
+    const T mirroredTransposed = mirrorHorizontal(transposed);
+    return {x,          mirrored,          mirrorVertical(x),          mirrorVertical(mirrored),
+            transposed, mirroredTransposed, mirrorVertical(transposed), mirrorVertical(mirroredTransposed)};
+}
+
+/// reduce every nibble to its lowest bit, which is set if any bit of the nibble is set
+template <typename T>
+inline T anyBitPerNibble(T x)
+{
+    x |= x >> 2U;
+    x |= x >> 1U;
+    return x & NIBBLE_LSB;
+}
+
+/// lowest bit of every nibble is set if the nibble is zero
+template <typename T>
+inline T emptyNibbles(T x)
+{
+    return ~anyBitPerNibble(x) & NIBBLE_LSB;
+}
+
+/// 1 if x != 0, 0 otherwise
+template <typename T>
+inline T nonZero(T x)
+{
+    return (x | (T{} - x)) >> 63U;
+}
+
+/// Bit mask of the legal directions (see MoveMask)
+template <typename T>
+inline T legalMoves(T values)
+{
+    // lowest bit of every nibble that has a right neighbour in the same row (x < 3)
+    constexpr uint64_t HAS_RIGHT = 0x0111011101110111ULL;
+    // lowest bit of every nibble that has a neighbour in the row below (y < 3)
+    constexpr uint64_t HAS_BELOW = 0x0000111111111111ULL;
+
+    const T occupied = anyBitPerNibble(values);
+    const T empty = ~occupied & NIBBLE_LSB;
+    // 32768 tiles don't merge in the move tables
+    const T mergeable = anyBitPerNibble(~values);
+    // a nibble is equal to its right/lower neighbour if the xor of both is zero
+    const T equalRight = emptyNibbles(values ^ (values >> BITS_PER_NIBBLE)) & mergeable & HAS_RIGHT;
+    const T equalBelow = emptyNibbles(values ^ (values >> BITS_PER_ROW)) & mergeable & HAS_BELOW;
+
+    // a tile moves towards its neighbour if that one is empty or can be merged with
+    const T left = (occupied >> BITS_PER_NIBBLE) & (empty | equalRight) & HAS_RIGHT;
+    const T right = occupied & ((empty >> BITS_PER_NIBBLE) | equalRight) & HAS_RIGHT;
+    const T up = (occupied >> BITS_PER_ROW) & (empty | equalBelow) & HAS_BELOW;
+    const T down = occupied & ((empty >> BITS_PER_ROW) | equalBelow) & HAS_BELOW;
+
+    return (nonZero(up) * uint64_t{MOVE_UP}) | (nonZero(left) * uint64_t{MOVE_LEFT}) |
+           (nonZero(right) * uint64_t{MOVE_RIGHT}) | (nonZero(down) * uint64_t{MOVE_DOWN});
+}
+
+/// Result of moving every possible row (one 16 bit chunk of the board) to the left or right, see
+/// https://github.com/nneonneo/2048-ai/blob/master/2048.cpp for the idea
+struct MoveTables
+{
+    static constexpr size_t LEFT = 0;
+    static constexpr size_t RIGHT = NUM_ROWS;
+
+    /// moved rows, left moves first then right moves. The additional entries allow 64 bit gathers of the last row
+    std::array<uint16_t, 2 * NUM_ROWS + 3> rows{};
+    /// score of the moves in the same order, with one additional entry for 64 bit gathers
+    std::array<uint32_t, 2 * NUM_ROWS + 1> scores{};
+};
+
+/// Tables are created on first use
+const MoveTables& moveTables();
+
+}  // namespace g2048::bits
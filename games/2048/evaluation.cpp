@@ -0,0 +1,125 @@
+#include "evaluation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace g2048 {
+namespace {
+/// quotes and escapes a string for JSON
+std::string jsonString(const std::string& value)
+{
+    constexpr unsigned char FIRST_PRINTABLE = 0x20;
+    std::ostringstream stream;
+    stream << '"';
+    for (const char c : value)
+    {
+        switch (c)
+        {
+            case '"': stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < FIRST_PRINTABLE)
+                {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                }
+                else
+                {
+                    stream << c;
+                }
+        }
+    }
+    stream << '"';
+    return stream.str();
+}
+}  // namespace
+
+EvaluationSummary summarize(const std::vector<GameResult>& results)
+{
+    EvaluationSummary summary{};
+    summary.numGames = results.size();
+    if (results.empty()) { return summary; }
+
+    std::vector<float> scores;
+    for (const auto& result : results)
+    {
+        scores.push_back(result.score);
+        summary.meanScore += result.score;
+        summary.tileCounts[result.biggestTile]++;
+        summary.numMoves += result.numMoves;
+        summary.duration += result.duration;
+    }
+    summary.meanScore /= double(results.size());
+
+    std::sort(scores.begin(), scores.end());
+    constexpr double HUNDRED = 100.0;
+    for (size_t i = 0; i < PERCENTILES.size(); ++i)
+    {
+        // nearest rank: smallest score such that at least the given percentage of all scores is not bigger
+        const auto rank = size_t(std::ceil(double(PERCENTILES.at(i)) / HUNDRED * double(scores.size())));
+        summary.scorePercentiles.at(i) = scores[std::max(rank, size_t(1)) - 1];
+    }
+    return summary;
+}
+
+void printSummary(const EvaluationSummary& summary, std::ostream& stream)
+{
+    constexpr size_t PRINT_WIDTH = 5;
+    for (const auto& [tile, count] : summary.tileCounts)
+    {
+        stream << "Received tile " << std::setw(PRINT_WIDTH) << tile << " " << count << " out of " << summary.numGames
+               << " times\n";
+    }
+    stream << "Score: mean " << std::fixed << std::setprecision(1) << summary.meanScore;
+    for (size_t i = 0; i < PERCENTILES.size(); ++i)
+    {
+        stream << ", p" << PERCENTILES.at(i) << " " << summary.scorePercentiles.at(i);
+    }
+    stream << "\nEvaluated " << summary.numMoves << " moves in "
+           << std::chrono::duration_cast<std::chrono::milliseconds>(summary.duration).count()
+           << " ms, averaged: " << summary.microsecondsPerMove() << "us/move\n";
+}
+
+bool writeJson(const std::string& path, const std::string& name, const EvaluationParameter& param,
+               const EvaluationSummary& summary, const std::vector<GameResult>& results)
+{
+    std::ofstream file(path);
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    file << "{\n";
+    file << "  \"name\": " << jsonString(name) << ",\n";
+    file << "  \"seed\": " << param.seed << ",\n";
+    file << "  \"num_games\": " << summary.numGames << ",\n";
+    file << "  \"mean_score\": " << summary.meanScore << ",\n";
+    file << "  \"score_percentiles\": {";
+    for (size_t i = 0; i < PERCENTILES.size(); ++i)
+    {
+        file << (i == 0 ? "" : ", ") << "\"" << PERCENTILES.at(i) << "\": " << summary.scorePercentiles.at(i);
+    }
+    file << "},\n";
+    file << "  \"tile_counts\": {";
+    for (auto it = summary.tileCounts.begin(); it != summary.tileCounts.end(); ++it)
+    {
+        file << (it == summary.tileCounts.begin() ? "" : ", ") << "\"" << it->first << "\": " << it->second;
+    }
+    file << "},\n";
+    file << "  \"num_moves\": " << summary.numMoves << ",\n";
+    file << "  \"duration_us\": " << summary.duration.count() << ",\n";
+    file << "  \"us_per_move\": " << summary.microsecondsPerMove() << ",\n";
+    file << "  \"games\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        file << "    {\"seed\": " << result.seed << ", \"score\": " << result.score
+             << ", \"biggest_tile\": " << result.biggestTile << ", \"num_moves\": " << result.numMoves
+             << ", \"duration_us\": " << result.duration.count() << "}" << (i + 1 < results.size() ? "," : "")
+             << "\n";
+    }
+    file << "  ]\n}\n";
+    return file.good();
+}
+}  // namespace g2048
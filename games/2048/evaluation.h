@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "2048.h"
+#include "mcts/random.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace g2048 {
+
+struct GameResult
+{
+    uint64_t seed{};
+    float score{};
+    size_t biggestTile{};
+    size_t numMoves{};
+    std::chrono::microseconds duration{};
+};
+
+/// score percentiles that are reported by summarize()
+constexpr std::array<size_t, 7> PERCENTILES = {0, 10, 25, 50, 75, 90, 100};
+
+struct EvaluationSummary
+{
+    size_t numGames{};
+    double meanScore{};
+    /// nearest rank percentiles of the score, in the order of PERCENTILES
+    std::array<float, PERCENTILES.size()> scorePercentiles{};
+    /// number of games per biggest tile
+    std::map<size_t, size_t> tileCounts{};
+    size_t numMoves{};
+    /// sum of the game durations
+    std::chrono::microseconds duration{};
+
+    [[nodiscard]] double microsecondsPerMove() const
+    {
+        return numMoves == 0 ? 0.0 : double(duration.count()) / double(numMoves);
+    }
+};
+
+struct EvaluationParameter
+{
+    size_t numGames = 1000;  // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    /// game i is played with the seed mcts::splitMix64(seed + i)
+    uint64_t seed = 0;
+    /// 0 uses one thread per core
+    size_t numThreads = 0;
+};
+
+/// Plays one game from the empty board, decisions are taken by the policy and chance events are drawn from the problem
+template <typename Policy>
+GameResult playGame(Policy& policy, const G2048Problem& problem)
+{
+    G2048State state;
+    GameResult result{};
+    const auto start = std::chrono::steady_clock::now();
+    while (!problem.isTerminal(state))
+    {
+        if (problem.getNextStageType(state) == mcts::StageType::DECISION)
+        {
+            result.score += problem.performAction(policy.getAction(state, problem), state);
+            result.numMoves++;
+        }
+        else
+        {
+            result.score += problem.performRandomChanceEvent(state);
+        }
+    }
+    result.duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    result.biggestTile = state.board().biggestTile();
+    return result;
+}
+
+/**
+ * @brief Plays param.numGames games on a pool of threads. Every game gets its own problem and its own policy, created
+ * with makePolicy(seed), so policies don't need to be thread-safe. If the policy seeds its random numbers with the
+ * given seed, every game is reproducible: apart from the durations, the results don't depend on the number of threads.
+ * @return results in the order of the games
+ */
+template <typename MakePolicy>
+std::vector<GameResult> evaluateParallel(MakePolicy makePolicy, const EvaluationParameter& param)
+{
+    std::vector<GameResult> results(param.numGames);
+    std::atomic<size_t> nextGame{0};
+    auto worker = [&]() {
+        // the random numbers of a game must not depend on the thread that plays it
+        mcts::setThreadStream(0);
+        for (size_t game = nextGame++; game < param.numGames; game = nextGame++)
+        {
+            const uint64_t seed = mcts::splitMix64(param.seed + game);
+            const G2048Problem problem(seed);
+            auto policy = makePolicy(seed);
+            results[game] = playGame(policy, problem);
+            results[game].seed = seed;
+        }
+    };
+
+    const size_t numThreads = param.numThreads != 0 ? param.numThreads : std::thread::hardware_concurrency();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < std::max(numThreads, size_t(1)); ++i) { threads.emplace_back(worker); }
+    for (auto& thread : threads) { thread.join(); }
+    return results;
+}
+
+[[nodiscard]] EvaluationSummary summarize(const std::vector<GameResult>& results);
+void printSummary(const EvaluationSummary& summary, std::ostream& stream);
+
+/// Writes the parameters, the summary and all games as JSON object, returns false on failure
+bool writeJson(const std::string& path, const std::string& name, const EvaluationParameter& param,
+               const EvaluationSummary& summary, const std::vector<GameResult>& results);
+}  // namespace g2048
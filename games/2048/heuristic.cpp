@@ -0,0 +1,97 @@
+#include "heuristic.h"
+
+#include "board_bits.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace g2048 {
+namespace {
+using bits::BITS_PER_NIBBLE;
+using bits::BITS_PER_ROW;
+using bits::NIBBLE_MASK;
+using bits::NUM_ROWS;
+using bits::ROW_MASK;
+
+/// Per row contributions to the positional features
+struct RowFeatures
+{
+    /// exponent of the first minus the last cell. The drops between neighbouring cells telescope to this value
+    int8_t difference;
+    uint8_t numEmpty;
+    uint8_t maxExp;
+    /// biggest exponent of the first and the last cell, i.e. of the corners if this is the top or bottom row
+    uint8_t cornerExp;
+};
+
+using RowTable = std::array<RowFeatures, NUM_ROWS>;
+
+std::unique_ptr<RowTable> createRowTable()
+{
+    auto table = std::make_unique<RowTable>();
+    for (size_t row = 0; row < NUM_ROWS; ++row)
+    {
+        std::array<uint8_t, BOARD_DIMS> cells{};
+        for (uint32_t x = 0; x < BOARD_DIMS; ++x)
+        {
+            cells.at(x) = static_cast<uint8_t>((row >> (BITS_PER_NIBBLE * x)) & NIBBLE_MASK);
+        }
+        auto& features = table->at(row);
+        features.difference = static_cast<int8_t>(cells.front() - cells.back());
+        features.numEmpty = static_cast<uint8_t>(std::count(cells.begin(), cells.end(), 0));
+        features.maxExp = *std::max_element(cells.begin(), cells.end());
+        features.cornerExp = std::max(cells.front(), cells.back());
+    }
+    return table;
+}
+
+const RowTable& rowTable()
+{
+    static const std::unique_ptr<RowTable> TABLE = createRowTable();
+    return *TABLE;
+}
+
+inline size_t row(uint64_t values, uint32_t y)
+{
+    return (values >> (BITS_PER_ROW * y)) & ROW_MASK;
+}
+}  // namespace
+
+PositionalFeatures positionalFeatures(const Board& board)
+{
+    const auto& table = rowTable();
+    const uint64_t rows = board.raw();
+    const uint64_t columns = bits::transpose(rows);
+
+    const RowFeatures& top = table[row(rows, 0)];
+    const RowFeatures& bottom = table[row(rows, BOARD_DIMS - 1)];
+
+    // the last row and column have no lower respectively right neighbours and don't count towards the difference
+    int difference = 0;
+    int numEmpty = bottom.numEmpty;
+    uint8_t maxExp = bottom.maxExp;
+    for (uint32_t y = 0; y < BOARD_DIMS - 1; ++y)
+    {
+        const RowFeatures& features = table[row(rows, y)];
+        difference += features.difference + table[row(columns, y)].difference;
+        numEmpty += features.numEmpty;
+        maxExp = std::max(maxExp, features.maxExp);
+    }
+
+    PositionalFeatures result;
+    result.difference = -float(difference);
+    result.numEmpty = float(numEmpty);
+    result.cornerHighest = -float(maxExp - std::max(top.cornerExp, bottom.cornerExp));
+    return result;
+}
+
+float positionalScore(const Board& board)
+{
+    constexpr float W_DIFFERENCE = 10.0f;
+    constexpr float W_EMPTY = 1.0f;
+    constexpr float W_CORNER = 100.0f;
+    const PositionalFeatures features = positionalFeatures(board);
+    return W_DIFFERENCE * features.difference + W_EMPTY * features.numEmpty + W_CORNER * features.cornerHighest;
+}
+
+}  // namespace g2048
@@ -0,0 +1,49 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "board.h"
+
+namespace g2048 {
+
+/**
+ * @brief Components of the positional score of a board, see positionalScore().
+ * All of them are sums over rows and columns, so they are computed with one table lookup per row of the board and per
+ * row of the transposed board.
+ */
+struct PositionalFeatures
+{
+    /// minus the sum of all drops from a cell to its right and lower neighbour, boards sorted towards the top left
+    /// corner score highest
+    float difference{0};
+    float numEmpty{0};
+    /// minus the difference between the biggest exponent and the biggest exponent in a corner
+    float cornerHighest{0};
+};
+
+[[nodiscard]] PositionalFeatures positionalFeatures(const Board& board);
+
+/// Weighted sum of the positional features, cheap enough to be evaluated in every rollout step
+[[nodiscard]] float positionalScore(const Board& board);
+
+}  // namespace g2048
@@ -0,0 +1,221 @@
+#include "ntuple.h"
+
+#include "board_bits.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace g2048 {
+namespace {
+/// the weights start at this offset in the weight file, which keeps them page aligned
+constexpr size_t HEADER_SIZE = 4096;
+constexpr std::array<char, 8> MAGIC = {'N', 'T', 'U', 'P', 'L', 'E', '0', '1'};
+constexpr uint8_t UNUSED_CELL = 0xFF;
+
+struct FileHeader
+{
+    std::array<char, 8> magic;
+    uint32_t numTuples;
+    /// cells of every tuple, filled up with UNUSED_CELL
+    std::array<std::array<uint8_t, NTupleNetwork::MAX_TUPLE_SIZE>, NTupleNetwork::MAX_TUPLES> cells;
+};
+static_assert(sizeof(FileHeader) <= HEADER_SIZE);
+static_assert(NTupleNetwork::NUM_SYMMETRIES == bits::NUM_SYMMETRIES);
+
+uint32_t move(Board& board, Actions action)
+{
+    switch (action)
+    {
+        case Actions::UP:
+            return board.moveUp();
+        case Actions::LEFT:
+            return board.moveLeft();
+        case Actions::RIGHT:
+            return board.moveRight();
+        case Actions::DOWN:
+            return board.moveDown();
+    }
+    assert(false);
+    return 0;
+}
+}  // namespace
+
+std::vector<NTupleNetwork::Tuple> NTupleNetwork::defaultTuples()
+{
+    return {{0, 1, 2, 3, 4, 5}, {4, 5, 6, 7, 8, 9}, {0, 1, 2, 4, 5, 6}, {4, 5, 6, 8, 9, 10}};  // NOLINT
+}
+
+NTupleNetwork::NTupleNetwork(std::vector<Tuple> tuples)
+{
+    init(std::move(tuples));
+    ownedWeights_.assign(numWeights_, 0.0f);
+    weights_ = ownedWeights_.data();
+}
+
+void NTupleNetwork::init(std::vector<Tuple> tuples)
+{
+    assert(tuples.size() <= MAX_TUPLES);
+    tuples_ = std::move(tuples);
+    offsets_.clear();
+    numWeights_ = 0;
+    for (const auto& tuple : tuples_)
+    {
+        assert(!tuple.empty() && tuple.size() <= MAX_TUPLE_SIZE);
+        offsets_.push_back(numWeights_);
+        numWeights_ += size_t(1) << (bits::BITS_PER_NIBBLE * tuple.size());
+    }
+}
+
+void NTupleNetwork::Unmap::operator()(void* data) const
+{
+    ::munmap(data, size);
+}
+
+std::optional<NTupleNetwork> NTupleNetwork::load(const std::string& path)
+{
+    const int file = ::open(path.c_str(), O_RDONLY);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (file < 0) { return std::nullopt; }
+    struct stat info
+    {
+    };
+    const bool valid = ::fstat(file, &info) == 0 && size_t(info.st_size) >= HEADER_SIZE;
+    const size_t size = valid ? size_t(info.st_size) : 0;
+    // private mapping: writes to the weights stay in memory and never reach the file
+    void* data = valid ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    ::close(file);
+    if (data == MAP_FAILED) { return std::nullopt; }
+    std::unique_ptr<void, Unmap> mapping(data, Unmap{size});
+
+    FileHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.numTuples > MAX_TUPLES) { return std::nullopt; }
+
+    std::vector<Tuple> tuples(header.numTuples);
+    for (size_t t = 0; t < tuples.size(); ++t)
+    {
+        for (const uint8_t cell : header.cells.at(t))
+        {
+            if (cell == UNUSED_CELL) { break; }
+            if (cell >= NUM_CELLS) { return std::nullopt; }
+            tuples[t].push_back(cell);
+        }
+        if (tuples[t].empty()) { return std::nullopt; }
+    }
+
+    NTupleNetwork network(std::vector<Tuple>{});
+    network.init(std::move(tuples));
+    if (size != HEADER_SIZE + network.numWeights_ * sizeof(float)) { return std::nullopt; }
+    network.weights_ = reinterpret_cast<float*>(static_cast<char*>(data) + HEADER_SIZE);  // NOLINT
+    network.mapping_ = std::move(mapping);
+    return network;
+}
+
+bool NTupleNetwork::save(const std::string& path) const
+{
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.numTuples = uint32_t(tuples_.size());
+    for (auto& cells : header.cells) { cells.fill(UNUSED_CELL); }
+    for (size_t t = 0; t < tuples_.size(); ++t)
+    {
+        std::copy(tuples_[t].begin(), tuples_[t].end(), header.cells.at(t).begin());
+    }
+
+    std::array<char, HEADER_SIZE> buffer{};
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // the weights may be mapped from the file at path, so write a new file and replace the old one afterwards
+    const std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), buffer.size());
+    file.write(reinterpret_cast<const char*>(weights_), std::streamsize(numWeights_ * sizeof(float)));  // NOLINT
+    file.close();
+    return file.good() && std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+size_t NTupleNetwork::index(uint64_t board, size_t tuple) const
+{
+    size_t index = 0;
+    for (size_t i = 0; i < tuples_[tuple].size(); ++i)
+    {
+        const uint64_t cell = (board >> (bits::BITS_PER_NIBBLE * tuples_[tuple][i])) & bits::NIBBLE_MASK;
+        index |= cell << (bits::BITS_PER_NIBBLE * i);
+    }
+    return offsets_[tuple] + index;
+}
+
+float NTupleNetwork::value(const Board& board) const
+{
+    float sum = 0;
+    for (const uint64_t symmetric : bits::symmetries(board.raw()))
+    {
+        for (size_t t = 0; t < tuples_.size(); ++t) { sum += weights_[index(symmetric, t)]; }  // NOLINT
+    }
+    return sum;
+}
+
+void NTupleNetwork::update(const Board& board, float delta)
+{
+    const float weightDelta = delta / float(NUM_SYMMETRIES * tuples_.size());
+    for (const uint64_t symmetric : bits::symmetries(board.raw()))
+    {
+        for (size_t t = 0; t < tuples_.size(); ++t) { weights_[index(symmetric, t)] += weightDelta; }  // NOLINT
+    }
+}
+
+std::optional<std::pair<Actions, float>> bestAfterstate(const NTupleNetwork& network, const G2048State& state)
+{
+    assert(!state.isChanceNext());
+    const uint8_t legalMoves = state.board().legalMoves();
+
+    std::optional<std::pair<Actions, float>> best{};
+    for (const auto action : {Actions::UP, Actions::LEFT, Actions::RIGHT, Actions::DOWN})
+    {
+        if ((legalMoves & (1U << uint8_t(action))) == 0) { continue; }
+        Board afterstate = state.board();
+        const float value = float(move(afterstate, action)) + network.value(afterstate);
+        if (!best || value > best->second) { best = {action, value}; }
+    }
+    return best;
+}
+
+float playTrainingGame(const NTupleNetwork& network, const G2048Problem& problem, std::vector<TDTarget>& targets)
+{
+    G2048State state;
+    problem.performRandomChanceEvent(state);
+
+    float score = 0;
+    std::optional<Board> previous{};
+    while (const auto best = bestAfterstate(network, state))
+    {
+        // best->second is the reward of this move plus the value of its afterstate, the target of the previous one
+        if (previous) { targets.push_back({*previous, best->second}); }
+        score += problem.performAction(best->first, state);
+        previous = state.board();
+        problem.performRandomChanceEvent(state);
+    }
+    if (previous) { targets.push_back({*previous, 0.0f}); }
+    return score;
+}
+
+Actions NTuplePolicy::getAction(const G2048State& state, [[maybe_unused]] const G2048Problem& problem) const
+{
+    const auto best = bestAfterstate(*network_, state);
+    assert(best);
+    return best->first;
+}
+
+float NTupleRolloutPolicy::rollout(const G2048State& state, [[maybe_unused]] const G2048Problem& problem) const
+{
+    if (state.isChanceNext()) { return network_->value(state.board()); }
+    const auto best = bestAfterstate(*network_, state);
+    return best ? best->second : 0.0f;
+}
+}  // namespace g2048
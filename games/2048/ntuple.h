@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "2048.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace g2048 {
+
+/**
+ * @brief N-tuple network (Szubert & Jaśkowski 2014) approximating the expected future score of a 2048 afterstate,
+ * i.e. a board directly after a move and before the random tile is spawned.
+ *
+ * Every tuple is a list of cells. The tile exponents on these cells index a lookup table of 16^size weights, the value
+ * of a board is the sum of the looked up weights of all tuples over all 8 symmetries (rotations and reflections) of the
+ * board. All tables are stored in one flat array that can be memory mapped from a weight file.
+ */
+class NTupleNetwork
+{
+  public:
+    /// cell indices (BOARD_DIMS * y + x) of a tuple
+    using Tuple = std::vector<uint8_t>;
+
+    static constexpr size_t NUM_SYMMETRIES = 8;
+    static constexpr size_t MAX_TUPLES = 16;
+    static constexpr size_t MAX_TUPLE_SIZE = 6;
+
+    /// Four 6-tuples (Yeh et al. 2016), 64 MB of weights each: two rows of four cells with the first two cells of the
+    /// next row, and two 2x3 rectangles
+    static std::vector<Tuple> defaultTuples();
+
+    /// Network with all weights set to zero
+    explicit NTupleNetwork(std::vector<Tuple> tuples = defaultTuples());
+
+    /// Memory maps the weight file written by save() (copy on write, so the weights can be trained further without
+    /// changing the file). Returns nullopt if the file can't be read or is not a weight file
+    static std::optional<NTupleNetwork> load(const std::string& path);
+    /// Writes the weights to a file in native byte order, returns false on failure. The file may be the one this network
+    /// was loaded from
+    [[nodiscard]] bool save(const std::string& path) const;
+
+    [[nodiscard]] float value(const Board& board) const;
+    /// Changes the weights so that value(board) changes by delta (assuming all looked up weights are distinct)
+    void update(const Board& board, float delta);
+
+    [[nodiscard]] const std::vector<Tuple>& tuples() const { return tuples_; }
+    [[nodiscard]] size_t numWeights() const { return numWeights_; }
+
+  private:
+    /// the weights of a tuple are stored at offsets_[tuple] + index
+    [[nodiscard]] size_t index(uint64_t board, size_t tuple) const;
+    void init(std::vector<Tuple> tuples);
+
+    std::vector<Tuple> tuples_{};
+    std::vector<size_t> offsets_{};
+    size_t numWeights_{0};
+
+    struct Unmap
+    {
+        size_t size;
+        void operator()(void* data) const;
+    };
+
+    /// either owned weights or the memory mapped file
+    std::vector<float> ownedWeights_{};
+    std::unique_ptr<void, Unmap> mapping_{nullptr, Unmap{0}};
+    float* weights_{nullptr};
+};
+
+/// One step of TD(0) learning on afterstates: the value of the afterstate should be target
+struct TDTarget
+{
+    Board afterstate;
+    float target;
+};
+
+/**
+ * @brief Plays one game in which every move maximizes reward + value of the afterstate and appends the TD(0) targets of
+ * all afterstates to targets: the reward of the next move plus the value of the next afterstate, or 0 at the end of
+ * the game. Returns the score of the game
+ */
+float playTrainingGame(const NTupleNetwork& network, const G2048Problem& problem, std::vector<TDTarget>& targets);
+
+/// Best action of a decision state by reward + afterstate value, together with that sum. nullopt if no move is legal
+std::optional<std::pair<Actions, float>> bestAfterstate(const NTupleNetwork& network, const G2048State& state);
+
+/// Plays greedily with respect to the afterstate values of the network
+class NTuplePolicy
+{
+  public:
+    explicit NTuplePolicy(std::shared_ptr<const NTupleNetwork> network) : network_(std::move(network)) {}
+
+    [[nodiscard]] Actions getAction(const G2048State& state, const G2048Problem& problem) const;
+
+  private:
+    std::shared_ptr<const NTupleNetwork> network_;
+};
+
+/// Replaces the rollout of the solver by the value of the network, which is much cheaper than playing to the end
+class NTupleRolloutPolicy
+{
+  public:
+    explicit NTupleRolloutPolicy(std::shared_ptr<const NTupleNetwork> network) : network_(std::move(network)) {}
+
+    float rollout(const G2048State& state, const G2048Problem& problem) const;
+
+  private:
+    std::shared_ptr<const NTupleNetwork> network_;
+};
+}  // namespace g2048
@@ -1,5 +1,7 @@
 #include "policies.h"
 
+#include "heuristic.h"
+
 #include <algorithm>
 
 namespace g2048 {
@@ -46,12 +48,8 @@ Actions BestPositionPolicy::getAction(const g2048::G2048State& state, const g204
 
 float BestPositionPolicy::getPositionalScore(const g2048::G2048State& state) const
 {
-    const float wDiff = 10.0f;
     const float wOrder = 5.0f;
-    const float wEmpty = 1.0f;
-    const float wCorner = 100.0f;
-    return wDiff * getDifferenceScore(state) + wOrder * getOrderingScore(state) + wEmpty * getEmptyFieldsScore(state) +
-           wCorner * getCornerHighestScore(state);
+    return positionalScore(state.board()) + wOrder * getOrderingScore(state);
 }
 
 float BestPositionPolicy::getOrderingScore([[maybe_unused]] const g2048::G2048State& state) const
@@ -59,22 +57,6 @@ float BestPositionPolicy::getOrderingScore([[maybe_unused]] const g2048::G2048St
     return 0;
 }
 
-float BestPositionPolicy::getDifferenceScore(const g2048::G2048State& state) const
-{
-    float value = 0;
-    for (uint8_t x = 0; x < BOARD_DIMS - 1; x++)
-    {
-        for (uint8_t y = 0; y < BOARD_DIMS - 1; y++)
-        {
-            value += 2 * float(state.board(x, y)) - float(state.board(x + 1, y)) - float(state.board(x, y + 1));
-        }
-    }
-    return -value;
-}
-float BestPositionPolicy::getEmptyFieldsScore(const g2048::G2048State& state) const
-{
-    return float(state.board().numEmpty());
-}
 float BestPositionPolicy::getOrderingScoreAlongPath(const g2048::G2048State& state,
                                                     const std::vector<Point>& path) const
 {
@@ -90,17 +72,17 @@ float BestPositionPolicy::getOrderingScoreAlongPath(const g2048::G2048State& sta
     return score;
 }
 
-float BestPositionPolicy::getCornerHighestScore(const g2048::G2048State& state) const
+ExpectimaxPolicy::ExpectimaxPolicy(size_t depth, float minProbability, bool canonicalKeys)
+    : solver_({depth, minProbability, true}, Heuristic{}, BoardKey{canonicalKeys})
 {
-    auto maxScore = float(state.board().biggestExp());
-    float maxError = maxScore;
-
-    maxError = std::min(maxError, maxScore - float(state.board(0, 0)));
-    maxError = std::min(maxError, maxScore - float(state.board(0, BOARD_DIMS - 1)));
-    maxError = std::min(maxError, maxScore - float(state.board(BOARD_DIMS - 1, 0)));
-    maxError = std::min(maxError, maxScore - float(state.board(BOARD_DIMS - 1, BOARD_DIMS - 1)));
+}
 
-    return -float(maxError);
+float ExpectimaxPolicy::Heuristic::operator()(const g2048::G2048State& state,
+                                              [[maybe_unused]] const g2048::G2048Problem& problem) const
+{
+    // terminal states are valued with 0, so every position that is still alive has to be worth more than that
+    constexpr float ALIVE_OFFSET = 10000.0f;
+    return ALIVE_OFFSET + policy.getPositionalScore(state);
 }
 
 }  // namespace g2048
\ No newline at end of file
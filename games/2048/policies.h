@@ -23,6 +23,7 @@
 #pragma once
 
 #include "2048.h"
+#include "mcts/expectimax.h"
 #include "mcts/rollout/random_rollout.h"
 
 namespace g2048 {
@@ -43,6 +44,9 @@ class BestPositionPolicy
   public:
     [[nodiscard]] Actions getAction(const g2048::G2048State& state, const g2048::G2048Problem& problem) const;
 
+    /// Difference, empty field and corner score of g2048::positionalScore plus the ordering score
+    [[nodiscard]] float getPositionalScore(const g2048::G2048State& state) const;
+
   private:
     struct Point
     {
@@ -51,36 +55,71 @@ class BestPositionPolicy
     };
     std::vector<std::vector<Point>> paths_;
 
-    [[nodiscard]] float getPositionalScore(const g2048::G2048State& state) const;
     [[nodiscard]] float getOrderingScore(const g2048::G2048State& state) const;
 
-    [[nodiscard]] float getDifferenceScore(const g2048::G2048State& state) const;
-    [[nodiscard]] float getEmptyFieldsScore(const g2048::G2048State& state) const;
-    [[nodiscard]] float getCornerHighestScore(const g2048::G2048State& state) const;
     [[nodiscard]] float getOrderingScoreAlongPath(const g2048::G2048State& state, const std::vector<Point>& path) const;
 };
 
+/// Depth limited expectimax search that evaluates its leaves with the positional score of the BestPositionPolicy
+class ExpectimaxPolicy
+{
+  public:
+    /// With canonicalKeys, all symmetric boards share one cache entry. This raises the hit rate, but the positional
+    /// score is not symmetric, so the value of a board is then approximated by the one of a symmetric board
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+    explicit ExpectimaxPolicy(size_t depth = 2, float minProbability = 1e-3f, bool canonicalKeys = false);
+
+    [[nodiscard]] Actions getAction(const g2048::G2048State& state, const g2048::G2048Problem& problem)
+    {
+        return solver_.run(problem, state);
+    }
+
+    [[nodiscard]] const auto& solver() const { return solver_; }
+
+  private:
+    struct Heuristic
+    {
+        float operator()(const g2048::G2048State& state, const g2048::G2048Problem& problem) const;
+        BestPositionPolicy policy{};
+    };
+
+    /// decision states are fully described by their board
+    struct BoardKey
+    {
+        uint64_t operator()(const g2048::G2048State& state) const
+        {
+            return canonical ? state.board().canonical().raw() : state.board().raw();
+        }
+        bool canonical{false};
+    };
+
+    mcts::ExpectimaxSolver<g2048::G2048Problem, Heuristic, BoardKey> solver_;
+};
+
+/// Owns the solver, so that every game of an evaluation can search with its own tree
 template <class Solver>
 class MCTSPolicy
 {
   public:
-    MCTSPolicy(Solver& solver) : solver_(&solver) {}
-    [[nodiscard]] Actions getAction(const g2048::G2048State& state, const g2048::G2048Problem& problem) const
+    explicit MCTSPolicy(Solver solver) : solver_(std::move(solver)) {}
+    [[nodiscard]] Actions getAction(const g2048::G2048State& state, const g2048::G2048Problem& problem)
     {
         // try to find state in existing tree
-        const auto& tree = solver_->tree();
+        const auto& tree = solver_.tree();
         auto node = std::find_if(tree.begin(), tree.end(), [&state](const auto& node) { return node.state == state; });
         if (node != tree.end())
         {
-            auto action = solver_->runFromExistingTree(node->nodeId);
-            //            solver_->printTopLevelUtilities();
+            auto action = solver_.runFromExistingTree(node->nodeId);
+            //            solver_.printTopLevelUtilities();
             return action;
         }
-        return solver_->run(problem, state);
+        return solver_.run(problem, state);
     }
 
+    void seed(uint64_t seed) { solver_.seed(seed); }
+
   private:
-    Solver* solver_;
+    Solver solver_;
 };
 
 class MCRolloutPolicy : public mcts::RandomRolloutPolicy
@@ -1,55 +1,27 @@
 
 #include "2048.h"
+#include "evaluation.h"
 #include "mcts/selection/ucb1.h"
 #include "mcts/solver.h"
+#include "ntuple.h"
 #include "policies.h"
 
 #include <algorithm>
-#include <chrono>
-#include <fstream>
+#include <cctype>
+#include <functional>
+#include <iomanip>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace mcts;
 
 constexpr size_t DEFAULT_NUM_ITERATIONS = 1000;
 
-struct Result
-{
-    float score{};
-    size_t biggestTile{};
-    g2048::G2048State finalState;
-    size_t numMoves{};
-    std::chrono::microseconds duration{};
-};
-
-template <typename Policy>
-Result playG2048WithPolicy(Policy& policy)
-{
-    g2048::G2048State state;
-    g2048::G2048Problem game(std::random_device().operator()());
-    g2048::G2048Problem::ValueVector rewards{};
-    size_t numMoves = 0;
-    const auto start = std::chrono::system_clock::now();
-    while (!game.isTerminal(state))
-    {
-        if (game.getNextStageType(state) == mcts::StageType::DECISION)
-        {
-            auto action = policy.getAction(state, game);
-            rewards += game.performAction(action, state);
-            numMoves++;
-        }
-        else
-        {
-            rewards += game.performRandomChanceEvent(state);
-        }
-    }
-
-    const auto end = std::chrono::system_clock::now();
-    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    return {rewards, state.board().biggestTile(), state, numMoves, duration};
-}
-
 auto getMCTSSolverRandomRollout(size_t numIterations = DEFAULT_NUM_ITERATIONS)
 {
     mcts::UCB1SelectionPolicy<float> selectionPolicy({0, 500, 5});  // NOLINT
@@ -82,99 +54,256 @@ auto getMCTSSolverSmartRollout(size_t numIterations = DEFAULT_NUM_ITERATIONS)
     return solver;
 }
 
-void analyzeResults(std::vector<Result> results)
+auto getMCTSSolverNTuple(std::shared_ptr<const g2048::NTupleNetwork> network,
+                         size_t numIterations = DEFAULT_NUM_ITERATIONS)
 {
-    std::sort(results.begin(), results.end(), [](const Result& r1, const Result& r2) { return r1.score < r2.score; });
+    mcts::UCB1SelectionPolicy<float> selectionPolicy(UCB1SelectionPolicy<float>::Parameter{0, 500, 5});  // NOLINT
+    mcts::Solver<g2048::G2048Problem, UCB1SelectionPolicy<float>, g2048::NTupleRolloutPolicy> solver(
+        std::move(selectionPolicy), g2048::NTupleRolloutPolicy{std::move(network)});
+    solver.parameter().numIterations = numIterations;
 
-    using namespace std::chrono;
+    return solver;
+}
 
-    size_t overallMoves = 0;
-    microseconds overallDuration{};
-    std::map<size_t, size_t> tileCounter{};
-    for (const auto& r : results)
-    {
-        tileCounter[r.biggestTile]++;
-        overallMoves += r.numMoves;
-        overallDuration += r.duration;
-    }
+/// Creates the policy for a game, seeded with the seed of the game if it makes random decisions
+template <typename Policy, typename... Args>
+auto makeSeeded(Args... args)
+{
+    return [args...](uint64_t seed) {
+        Policy policy(args...);
+        if constexpr (mcts::detail::HAS_SEED<Policy>) { policy.seed(seed); }
+        return policy;
+    };
+}
 
-    for (const auto& counter : tileCounter)
-    {
-        constexpr size_t PRINT_WIDTH = 5;
-        std::cout << "Received tile " << std::setw(PRINT_WIDTH) << counter.first << " " << counter.second << " out of "
-                  << results.size() << " times\n";
-    }
+/// Plays count games in parallel with the policies created by makePolicy(seed) and writes the results to a JSON file
+template <typename MakePolicy>
+g2048::EvaluationSummary evaluatePolicy(const std::string& name, MakePolicy makePolicy, size_t count)
+{
+    std::cout << "#### " << name << ": " << std::endl;
+    g2048::EvaluationParameter param{};
+    param.numGames = count;
+    const auto results = g2048::evaluateParallel(makePolicy, param);
+    const auto summary = g2048::summarize(results);
+    g2048::printSummary(summary, std::cout);
 
-    std::cout << "Evaluated " << overallMoves << " in " << duration_cast<milliseconds>(overallDuration).count()
-              << " ms, averaged: " << double(overallDuration.count()) / overallMoves << "us/move \n";
+    std::string path = "evaluation_" + name + ".json";
+    std::replace_if(
+        path.begin(), path.end(), [](char c) { return std::isalnum(c) == 0 && c != '.' && c != '_'; }, '_');
+    if (!g2048::writeJson(path, name, param, summary, results)) { std::cerr << "Could not write " << path << "\n"; }
+    return summary;
 }
 
-template <typename Policy>
-std::vector<Result> evaluatePolicy(Policy policy, size_t count)
+/// Creates MCTS policies for a game with a solver from makeSolver, seeded with the seed of the game
+template <typename MakeSolver>
+auto makeMCTS(MakeSolver makeSolver)
 {
-    std::vector<Result> results;
-    std::cout << "[";
-    for (size_t i = 0; i < count; ++i)
-    {
-        results.push_back(playG2048WithPolicy(policy));
-        //        std::cout << "##";
-        std::cout.flush();
-    }
-    std::cout << "]\n";
-    analyzeResults(results);
-    return results;
+    return [makeSolver](uint64_t seed) {
+        g2048::MCTSPolicy policy{makeSolver()};
+        policy.seed(seed);
+        return policy;
+    };
+}
+
+/// Time per move of the policies created by makePolicy(seed), measured on a few games that are not evaluated
+template <typename MakePolicy>
+double measureMicrosecondsPerMove(MakePolicy makePolicy)
+{
+    constexpr size_t CALIBRATION_GAMES = 4;
+    constexpr uint64_t CALIBRATION_SEED = 1000000;
+    g2048::EvaluationParameter param{};
+    param.numGames = CALIBRATION_GAMES;
+    param.seed = CALIBRATION_SEED;
+    return g2048::summarize(g2048::evaluateParallel(makePolicy, param)).microsecondsPerMove();
 }
 
-int main(int, char**)
+/// Evaluates MCTS with heuristic rollouts with as many iterations as fit into the time per move of the reference
+template <typename MakeReference>
+g2048::EvaluationSummary evaluateMCTSAtTimeOf(const std::string& name, MakeReference makeReference, size_t count)
+{
+    constexpr size_t PROBE_ITERATIONS = 100;
+    const double referenceTime = measureMicrosecondsPerMove(makeReference);
+    const double probeTime =
+        measureMicrosecondsPerMove(makeMCTS([]() { return getMCTSSolverHeuristicRollout(PROBE_ITERATIONS); }));
+    const auto iterations = std::max(size_t(1), size_t(double(PROBE_ITERATIONS) * referenceTime / probeTime));
+    std::cout << "Reference takes " << referenceTime << "us/move, MCTS with " << PROBE_ITERATIONS << " iterations "
+              << probeTime << "us/move, so MCTS gets " << iterations << " iterations" << std::endl;
+
+    return evaluatePolicy(name + " (" + std::to_string(iterations) + " iterations)",
+                          makeMCTS([iterations]() { return getMCTSSolverHeuristicRollout(iterations); }), count);
+}
+
+struct Evaluation
+{
+    std::string name;
+    std::function<g2048::EvaluationSummary(const std::string& name, size_t count)> run;
+};
+
+/// All evaluations in the order they run, the MCTS evaluations take seconds per game
+std::vector<Evaluation> evaluations(const std::shared_ptr<const g2048::NTupleNetwork>& network)
 {
-    constexpr size_t COUNT = 1000;
+    std::vector<Evaluation> list = {
+        {"RandomPolicy",
+         [](const auto& name, size_t count) { return evaluatePolicy(name, makeSeeded<RandomPolicy>(), count); }},
+        {"BestPositionPolicy",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(name, makeSeeded<g2048::BestPositionPolicy>(), count);
+         }},
+        {"FixedSequence",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(name, makeSeeded<g2048::FixedSequencePolicy>(), count);
+         }},
+        {"MCRolloutPolicy (10 / 10 / 0.95)",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(name, makeSeeded<g2048::MCRolloutPolicy>(10, 10, 0.95f), count);  // NOLINT
+         }},
+        {"MCRolloutPolicy",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(name, makeSeeded<g2048::MCRolloutPolicy>(), count);
+         }},
+        {"Expectimax (depth 2)",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(name, makeSeeded<g2048::ExpectimaxPolicy>(2), count);  // NOLINT
+         }},
+        {"Expectimax (depth 2) with canonical cache keys",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(name, makeSeeded<g2048::ExpectimaxPolicy>(2, 1e-3f, true), count);  // NOLINT
+         }},
+        {"MCTS (100) with heuristic rollout",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(
+                 name, makeMCTS([]() { return getMCTSSolverHeuristicRollout(100); }), count);  // NOLINT
+         }},
+        {"MCTS (500) with heuristic rollout",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(
+                 name, makeMCTS([]() { return getMCTSSolverHeuristicRollout(500); }), count);  // NOLINT
+         }},
+        {"MCTS (100) with random rollout",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(
+                 name, makeMCTS([]() { return getMCTSSolverRandomRollout(100); }), count);  // NOLINT
+         }},
+        {"MCTS (1000) with random rollout",
+         [](const auto& name, size_t count) {
+             return evaluatePolicy(
+                 name, makeMCTS([]() { return getMCTSSolverRandomRollout(1000); }), count);  // NOLINT
+         }},
+        // compares MCTS and expectimax at equal time per move, together with "Expectimax (depth 2)"
+        {"MCTS with heuristic rollout at the time of Expectimax (depth 2)",
+         [](const auto& name, size_t count) {
+             return evaluateMCTSAtTimeOf(name, makeSeeded<g2048::ExpectimaxPolicy>(2), count);  // NOLINT
+         }},
+    };
 
+    if (network)
     {
-        std::cout << "#### RandomPolicy: " << std::endl;
-        evaluatePolicy(RandomPolicy{}, COUNT);
+        list.push_back({"NTuplePolicy", [network](const auto& name, size_t count) {
+                            return evaluatePolicy(name, makeSeeded<g2048::NTuplePolicy>(network), count);
+                        }});
+        list.push_back({"MCTS (100) with n-tuple evaluation", [network](const auto& name, size_t count) {
+                            return evaluatePolicy(
+                                name, makeMCTS([network]() { return getMCTSSolverNTuple(network, 100); }),  // NOLINT
+                                count);
+                        }});
     }
+    return list;
+}
 
+int usage()
+{
+    std::cerr << "Usage: solve2048 [--games <count>] [--weights <file>] [<filter>...]\n";
+    return 1;
+}
+
+/// the number of games given to --games, which has to be a positive number
+std::optional<size_t> parseCount(const std::string& text)
+{
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); }))
     {
-        std::cout << "#### BestPositionPolicy: " << std::endl;
-        evaluatePolicy(g2048::BestPositionPolicy{}, COUNT);
+        return std::nullopt;
     }
-
+    try
     {
-        std::cout << "#### FixedSequence: " << std::endl;
-        evaluatePolicy(g2048::FixedSequencePolicy{}, COUNT);
+        const size_t count = std::stoul(text);
+        if (count > 0) { return count; }
     }
-
+    catch (const std::out_of_range&)
     {
-        std::cout << "#### MCRolloutPolicy (1 / 10 / 0.95): " << std::endl;
-        evaluatePolicy(g2048::MCRolloutPolicy{10, 10, 0.95f}, COUNT);  // NOLINT
     }
+    return std::nullopt;
+}
 
-    return 0;
+/**
+ * Usage: solve2048 [--games <count>] [--weights <file>] [<filter>...]
+ *
+ * Evaluates all policies whose name contains one of the filters (all policies without filter) on the same games.
+ * --weights adds the policies based on the n-tuple weights written by train_ntuple
+ */
+int main(int argc, char** argv)
+{
+    constexpr size_t DEFAULT_COUNT = 1000;
 
+    size_t count = DEFAULT_COUNT;
+    std::string weights;
+    std::vector<std::string> filters;
+    const std::vector<std::string> args(argv + 1, argv + argc);  // NOLINT
+    for (size_t i = 0; i < args.size(); ++i)
     {
-        std::cout << "#### MCRolloutPolicy: " << std::endl;
-        evaluatePolicy(g2048::MCRolloutPolicy{}, COUNT);
+        if ((args[i] == "--games" || args[i] == "--weights") && i + 1 == args.size()) { return usage(); }
+        if (args[i] == "--games")
+        {
+            const auto parsed = parseCount(args[++i]);
+            if (!parsed)
+            {
+                std::cerr << "Invalid number of games: " << args[i] << "\n";
+                return usage();
+            }
+            count = *parsed;
+        }
+        else if (args[i] == "--weights") { weights = args[++i]; }
+        else { filters.push_back(args[i]); }
     }
 
+    std::shared_ptr<const g2048::NTupleNetwork> network;
+    if (!weights.empty())
     {
-        std::cout << "#### MCTS (100) with heuristic rollout: " << std::endl;
-        auto solver = getMCTSSolverHeuristicRollout(100);  // NOLINT
-        evaluatePolicy(g2048::MCTSPolicy{solver}, COUNT);
+        auto loaded = g2048::NTupleNetwork::load(weights);
+        if (!loaded)
+        {
+            std::cerr << "Could not load n-tuple weights from " << weights << "\n";
+            return 1;
+        }
+        network = std::make_shared<const g2048::NTupleNetwork>(std::move(*loaded));
     }
+
+    const auto selected = [&filters](const std::string& name) {
+        return filters.empty() || std::any_of(filters.begin(), filters.end(), [&name](const std::string& filter) {
+                   return name.find(filter) != std::string::npos;
+               });
+    };
+
+    std::vector<std::pair<std::string, g2048::EvaluationSummary>> summaries;
+    for (const auto& evaluation : evaluations(network))
     {
-        std::cout << "#### MCTS (1000) with heuristic rollout: " << std::endl;
-        auto solver = getMCTSSolverHeuristicRollout(500);  // NOLINT
-        evaluatePolicy(g2048::MCTSPolicy{solver}, COUNT);
+        if (!selected(evaluation.name)) { continue; }
+        summaries.emplace_back(evaluation.name, evaluation.run(evaluation.name, count));
     }
-
+    if (summaries.empty())
     {
-        std::cout << "#### MCTS (100) with random rollout: " << std::endl;
-        auto solver = getMCTSSolverRandomRollout(100);  // NOLINT
-        evaluatePolicy(g2048::MCTSPolicy{solver}, COUNT);
+        std::cerr << "No policy matches the filters, available are:\n";
+        for (const auto& evaluation : evaluations(network)) { std::cerr << "  " << evaluation.name << "\n"; }
+        return 1;
     }
+
+    constexpr int NAME_WIDTH = 66;
+    constexpr int VALUE_WIDTH = 10;
+    std::cout << "#### Overview of " << count << " games per policy:\n";
+    for (const auto& [name, summary] : summaries)
     {
-        std::cout << "#### MCTS (1000) with random rollout: " << std::endl;
-        auto solver = getMCTSSolverRandomRollout(1000);  // NOLINT
-        evaluatePolicy(g2048::MCTSPolicy{solver}, COUNT);
+        std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << " mean score " << std::fixed
+                  << std::setprecision(1) << std::setw(VALUE_WIDTH) << summary.meanScore << ", "
+                  << std::setw(VALUE_WIDTH) << summary.microsecondsPerMove() << "us/move\n";
     }
-}
\ No newline at end of file
+    return 0;
+}
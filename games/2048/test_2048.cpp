@@ -1,7 +1,22 @@
 #include "2048.h"
+#include "batch_rollout.h"
+#include "board_bits.h"
+#include "evaluation.h"
+#include "heuristic.h"
+#include "mcts/expectimax.h"
+#include "mcts/solver.h"
+#include "ntuple.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
 TEST(Board, SetValues)
 {
     for (size_t y = 0; y < 4; ++y)
@@ -27,6 +42,737 @@ std::array<std::array<uint8_t, 4>, 4> transpose(std::array<std::array<uint8_t, 4
     return val;
 }
 
+/// Loop based implementation of G2048Problem::performAction before the move tables, used as reference
+float referencePerformAction(const g2048::Actions action, g2048::G2048State& state)
+{
+    assert(!state.isChanceNext());
+
+    float retval{0};
+
+    int start = 0;
+    int end = 0;
+    int increment = 1;
+    bool upDown = (action == g2048::UP || action == g2048::DOWN);
+    switch (action)
+    {
+        case g2048::UP:
+            start = 0;
+            end = g2048::BOARD_DIMS;
+            break;
+        case g2048::LEFT:
+            start = 0;
+            end = g2048::BOARD_DIMS;
+            break;
+        case g2048::RIGHT:
+            start = g2048::BOARD_DIMS - 1;
+            increment = -1;
+            end = -1;
+            break;
+        case g2048::DOWN:
+            start = g2048::BOARD_DIMS - 1;
+            increment = -1;
+            end = -1;
+            break;
+    }
+    size_t numUpdatedCells = 0;
+    for (size_t otherdim = 0; otherdim < g2048::BOARD_DIMS; otherdim++)
+    {
+        for (int xy = start; xy != end; xy += increment)
+        {
+            const size_t x = upDown ? otherdim : xy;
+            const size_t y = upDown ? xy : otherdim;
+            bool changed = false;
+            for (int xyd = xy + increment; xyd != end; xyd += increment)
+            {
+                const size_t xd = upDown ? otherdim : xyd;
+                const size_t yd = upDown ? xyd : otherdim;
+
+                if (state.board(xd, yd) == 0) { continue; }
+
+                if (state.board(x, y) == 0)
+                {
+                    state.setBoard(x, y, state.board(xd, yd));
+                    numUpdatedCells++;
+                    state.setBoard(xd, yd, 0);
+                    numUpdatedCells++;
+                    changed = true;
+                    break;
+                }
+                else if (state.board(x, y) == state.board(xd, yd))
+                {
+                    state.setBoard(x, y, state.board(x, y) + 1);
+                    numUpdatedCells++;
+                    retval += 1U << state.board(xd, yd);
+                    state.setBoard(xd, yd, 0);
+                    numUpdatedCells++;
+                    break;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            if (changed) { xy -= increment; }
+        }
+    }
+
+    const bool didChangeAnyCell = numUpdatedCells > 0;
+    state.setNextChance(didChangeAnyCell);
+    return retval;
+}
+
+TEST(Board, MoveTablesMatchReference)
+{
+    std::mt19937 engine{42};  // NOLINT
+    std::uniform_int_distribution<int> emptyDist(0, 2);
+    // 32768 + 32768 overflows the nibble in the reference implementation, so stay below
+    std::uniform_int_distribution<int> exponentDist(1, 14);  // NOLINT
+
+    constexpr size_t NUM_BOARDS = 100000;
+    for (size_t i = 0; i < NUM_BOARDS; ++i)
+    {
+        g2048::Board board{};
+        for (size_t y = 0; y < g2048::BOARD_DIMS; ++y)
+        {
+            for (size_t x = 0; x < g2048::BOARD_DIMS; ++x)
+            {
+                // small exponents in every other board to get many merges
+                const auto value = static_cast<uint8_t>((i % 2 == 0) ? exponentDist(engine) % 4 : exponentDist(engine));
+                board.set(x, y, emptyDist(engine) == 0 ? 0 : value);
+            }
+        }
+
+        for (auto action : {g2048::UP, g2048::LEFT, g2048::RIGHT, g2048::DOWN})
+        {
+            g2048::G2048State expected(board);
+            expected.setNextChance(false);
+            g2048::G2048State actual = expected;
+
+            const float expectedReward = referencePerformAction(action, expected);
+            const float actualReward = g2048::G2048Problem{}.performAction(action, actual);
+            ASSERT_EQ(actual, expected) << "action " << action << " on\n" << board;
+            ASSERT_EQ(actualReward, expectedReward) << "action " << action << " on\n" << board;
+        }
+    }
+}
+
+TEST(Board, MoveTablesDoNotOverflow)
+{
+    g2048::Board board{};
+    board.set(0, 0, 0xF);  // NOLINT
+    board.set(1, 0, 0xF);  // NOLINT
+    const auto before = board;
+    EXPECT_EQ(board.moveLeft(), 0);
+    EXPECT_EQ(board, before);
+}
+
+/// Cell scan of G2048Problem::canMove before the legality masks, used as reference
+uint8_t referenceLegalMoves(const g2048::Board& board)
+{
+    uint8_t retval = 0;
+    for (size_t x = 0; x < g2048::BOARD_DIMS; ++x)
+    {
+        for (size_t y = 0; y < g2048::BOARD_DIMS; ++y)
+        {
+            auto c = board.at(x, y);
+            if (x < g2048::BOARD_DIMS - 1)
+            {
+                auto cright = board.at(x + 1, y);
+                if (cright > 0 && (c == 0 || c == cright)) { retval |= g2048::MOVE_LEFT; }
+                if (c > 0 && (cright == 0 || c == cright)) { retval |= g2048::MOVE_RIGHT; }
+            }
+            if (y < g2048::BOARD_DIMS - 1)
+            {
+                auto cbelow = board.at(x, y + 1);
+                if (cbelow > 0 && (c == 0 || c == cbelow)) { retval |= g2048::MOVE_UP; }
+                if (c > 0 && (cbelow == 0 || c == cbelow)) { retval |= g2048::MOVE_DOWN; }
+            }
+        }
+    }
+    return retval;
+}
+
+TEST(Board, LegalMovesMatchReference)
+{
+    std::mt19937 engine{42};  // NOLINT
+    std::uniform_int_distribution<int> emptyDist(0, 3);
+    std::uniform_int_distribution<int> exponentDist(1, 15);  // NOLINT
+
+    constexpr size_t NUM_BOARDS = 100000;
+    size_t numTerminal = 0;
+    for (size_t i = 0; i < NUM_BOARDS; ++i)
+    {
+        g2048::Board board{};
+        for (size_t y = 0; y < g2048::BOARD_DIMS; ++y)
+        {
+            for (size_t x = 0; x < g2048::BOARD_DIMS; ++x)
+            {
+                // mostly full boards with many distinct tiles to also get terminal boards
+                const auto value = static_cast<uint8_t>(exponentDist(engine));
+                board.set(x, y, emptyDist(engine) == 0 && i % 2 == 0 ? 0 : value);
+            }
+        }
+
+        const uint8_t legal = board.legalMoves();
+        // the reference merges 32768 tiles, the move tables don't
+        if (board.biggestExp() < 0xF) { ASSERT_EQ(legal, referenceLegalMoves(board)) << board; }
+        numTerminal += legal == 0 ? 1 : 0;
+
+        // a move is legal exactly if it changes the board
+        const std::array<std::pair<g2048::MoveMask, uint32_t (g2048::Board::*)()>, 4> moves{{
+            {g2048::MOVE_UP, &g2048::Board::moveUp},
+            {g2048::MOVE_LEFT, &g2048::Board::moveLeft},
+            {g2048::MOVE_RIGHT, &g2048::Board::moveRight},
+            {g2048::MOVE_DOWN, &g2048::Board::moveDown},
+        }};
+        for (const auto& [bit, move] : moves)
+        {
+            g2048::Board moved = board;
+            (moved.*move)();
+            EXPECT_EQ((legal & bit) != 0, moved != board) << board;
+        }
+    }
+    EXPECT_GT(numTerminal, 0);
+}
+
+TEST(Board, EmptyCells)
+{
+    std::mt19937 engine{42};  // NOLINT
+    std::uniform_int_distribution<int> valueDist(0, 3);
+
+    for (size_t i = 0; i < 10000; ++i)  // NOLINT
+    {
+        g2048::Board board{};
+        std::vector<uint8_t> expectedEmpty{};
+        uint16_t expectedMask = 0;
+        for (uint8_t cell = 0; cell < g2048::NUM_CELLS; ++cell)
+        {
+            const auto value = static_cast<uint8_t>(valueDist(engine));
+            board.set(cell % g2048::BOARD_DIMS, cell / g2048::BOARD_DIMS, value);
+            if (value == 0)
+            {
+                expectedEmpty.push_back(cell);
+                expectedMask |= 1U << cell;
+            }
+        }
+
+        ASSERT_EQ(board.emptyMask(), expectedMask) << board;
+        ASSERT_EQ(board.numEmpty(), expectedEmpty.size());
+        for (size_t n = 0; n < expectedEmpty.size(); ++n) { ASSERT_EQ(board.emptyCell(n), expectedEmpty[n]); }
+    }
+
+    EXPECT_EQ(g2048::Board{}.emptyMask(), 0xFFFF);
+    EXPECT_EQ(g2048::Board{}.emptyCell(15), 15);  // NOLINT
+}
+
+TEST(G2048Problem, ChanceEvents)
+{
+    g2048::Board board{};
+    board.set(0, 0, 1);
+    board.set(3, 1, 2);
+    g2048::G2048State state(board, true);
+    g2048::G2048Problem problem{};
+
+    const auto events = problem.getAvailableChanceEvents(state);
+    ASSERT_EQ(events.size(), 2 * board.numEmpty());
+    float sum = 0;
+    for (const auto& [probability, event] : events)
+    {
+        EXPECT_EQ(board.at(event.x, event.y), 0);
+        sum += probability;
+    }
+    EXPECT_NEAR(sum, 1.0f, 1e-5);  // NOLINT
+
+    for (size_t i = 0; i < 100; ++i)  // NOLINT
+    {
+        g2048::G2048State spawned(board, true);
+        problem.performRandomChanceEvent(spawned);
+        EXPECT_EQ(spawned.board().numEmpty(), board.numEmpty() - 1);
+        EXPECT_EQ(spawned.board().raw() & board.raw(), board.raw());  // existing tiles untouched
+    }
+}
+
+TEST(G2048Problem, FactoredChanceEvents)
+{
+    g2048::Board board{};
+    board.set(0, 0, 1);
+    board.set(3, 1, 2);
+    const g2048::G2048State state(board, true);
+    const g2048::G2048Problem joint{};
+    const g2048::G2048Problem factored(0, g2048::ChanceMode::FACTORED);
+
+    // the product of the probabilities of both stages is the probability of the joint event with the same outcome
+    std::map<uint64_t, float> jointProbabilities;
+    for (const auto& [probability, event] : joint.getAvailableChanceEvents(state))
+    {
+        auto spawned = state;
+        joint.performChanceEvent(event, spawned);
+        jointProbabilities[spawned.board().raw()] = probability;
+    }
+
+    const auto cells = factored.getAvailableChanceEvents(state);
+    ASSERT_EQ(cells.size(), board.numEmpty());
+    for (const auto& [cellProbability, cellEvent] : cells)
+    {
+        auto chosen = state;
+        factored.performChanceEvent(cellEvent, chosen);
+        ASSERT_TRUE(chosen.isChanceNext());
+        EXPECT_EQ(chosen.board(), board);
+        EXPECT_NE(chosen, state);
+        EXPECT_NE(std::hash<g2048::G2048State>{}(chosen), std::hash<g2048::G2048State>{}(state));
+
+        const auto values = factored.getAvailableChanceEvents(chosen);
+        ASSERT_EQ(values.size(), 2);
+        for (const auto& [valueProbability, valueEvent] : values)
+        {
+            auto spawned = chosen;
+            factored.performChanceEvent(valueEvent, spawned);
+            EXPECT_FALSE(spawned.isChanceNext());
+            EXPECT_EQ(spawned.spawnCell(), g2048::G2048State::NO_SPAWN_CELL);
+            EXPECT_FLOAT_EQ(cellProbability * valueProbability, jointProbabilities.at(spawned.board().raw()));
+        }
+
+        // a random spawn respects the chosen cell
+        auto spawned = chosen;
+        factored.performRandomChanceEvent(spawned);
+        EXPECT_NE(spawned.board().at(cellEvent.x, cellEvent.y), 0);
+        EXPECT_EQ(spawned.board().numEmpty(), board.numEmpty() - 1);
+    }
+}
+
+/// Positions of random games, both before and after the tile spawn, including terminal ones
+std::vector<g2048::G2048State> randomGameStates(size_t numStates)
+{
+    constexpr size_t SEED = 42;
+    g2048::G2048Problem problem(SEED);
+    std::vector<g2048::G2048State> states;
+    g2048::G2048State state;
+    while (states.size() < numStates)
+    {
+        states.push_back(state);
+        if (problem.isTerminal(state)) { state = g2048::G2048State{}; }
+        else if (state.isChanceNext())
+        {
+            problem.performRandomChanceEvent(state);
+        }
+        else
+        {
+            problem.performRandomAction(state);
+        }
+    }
+    return states;
+}
+
+g2048::Board boardFromRaw(uint64_t raw)
+{
+    g2048::Board board{};
+    for (size_t cell = 0; cell < g2048::NUM_CELLS; ++cell)
+    {
+        board.set(cell % 4, cell / 4, (raw >> (4 * cell)) & 0xF);  // NOLINT
+    }
+    return board;
+}
+
+TEST(Board, Canonical)
+{
+    for (const auto& state : randomGameStates(500))  // NOLINT
+    {
+        const g2048::Board canonical = state.board().canonical();
+        const auto symmetries = g2048::bits::symmetries(state.board().raw());
+        EXPECT_NE(std::find(symmetries.begin(), symmetries.end(), canonical.raw()), symmetries.end());
+        EXPECT_EQ(canonical.raw(), *std::min_element(symmetries.begin(), symmetries.end()));
+        EXPECT_EQ(canonical.numEmpty(), state.board().numEmpty());
+        EXPECT_EQ(__builtin_popcount(canonical.legalMoves()), __builtin_popcount(state.board().legalMoves()));
+
+        // all symmetric boards share the canonical board
+        for (const uint64_t symmetric : symmetries)
+        {
+            const g2048::Board board = boardFromRaw(symmetric);
+            EXPECT_EQ(board.canonical(), canonical) << state.board() << board;
+        }
+    }
+}
+
+/// cell by cell computation of the positional features
+g2048::PositionalFeatures referencePositionalFeatures(const g2048::Board& board)
+{
+    constexpr size_t LAST = g2048::BOARD_DIMS - 1;
+    g2048::PositionalFeatures features{};
+    for (size_t x = 0; x < LAST; x++)
+    {
+        for (size_t y = 0; y < LAST; y++)
+        {
+            features.difference -= 2 * float(board.at(x, y)) - float(board.at(x + 1, y)) - float(board.at(x, y + 1));
+        }
+    }
+    features.numEmpty = float(board.numEmpty());
+
+    const auto maxExp = float(board.biggestExp());
+    float maxError = maxExp;
+    for (const auto& [x, y] : {std::pair{0UL, 0UL}, {0UL, LAST}, {LAST, 0UL}, {LAST, LAST}})
+    {
+        maxError = std::min(maxError, maxExp - float(board.at(x, y)));
+    }
+    features.cornerHighest = -maxError;
+    return features;
+}
+
+TEST(Heuristic, RowTablesMatchReference)
+{
+    std::vector<g2048::Board> boards;
+    for (const auto& state : randomGameStates(1000)) { boards.push_back(state.board()); }  // NOLINT
+    std::mt19937_64 engine(42);                                                             // NOLINT
+    for (size_t i = 0; i < 1000; ++i) { boards.push_back(boardFromRaw(engine())); }        // NOLINT
+
+    for (const auto& board : boards)
+    {
+        const auto features = g2048::positionalFeatures(board);
+        const auto reference = referencePositionalFeatures(board);
+        EXPECT_EQ(features.difference, reference.difference) << board;
+        EXPECT_EQ(features.numEmpty, reference.numEmpty) << board;
+        EXPECT_EQ(features.cornerHighest, reference.cornerHighest) << board;
+    }
+}
+
+TEST(G2048Problem, SharedBetweenThreads)
+{
+    constexpr size_t NUM_THREADS = 4;
+    const g2048::G2048Problem problem(3);  // NOLINT
+
+    // one random game per thread, all with the same problem
+    auto playInThreads = [&problem]() {
+        std::vector<g2048::G2048State> finalStates(NUM_THREADS);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back([&problem, &finalStates, i]() {
+                mcts::setThreadStream(i);
+                g2048::G2048State state;
+                while (!problem.isTerminal(state))
+                {
+                    if (state.isChanceNext()) { problem.performRandomChanceEvent(state); }
+                    else
+                    {
+                        problem.performRandomAction(state);
+                    }
+                }
+                finalStates[i] = state;
+            });
+        }
+        for (auto& thread : threads) { thread.join(); }
+        return finalStates;
+    };
+
+    const auto finalStates = playInThreads();
+    const auto repeated = playInThreads();
+    for (size_t i = 0; i < NUM_THREADS; ++i)
+    {
+        EXPECT_EQ(repeated[i].board(), finalStates[i].board());
+        if (i > 0) { EXPECT_NE(finalStates[i].board(), finalStates[0].board()); }
+    }
+}
+
+TEST(Evaluation, Reproducible)
+{
+    auto makePolicy = [](uint64_t seed) {
+        mcts::RandomPolicy policy{};
+        policy.seed(seed);
+        return policy;
+    };
+    g2048::EvaluationParameter param{};
+    param.numGames = 20;  // NOLINT
+    param.numThreads = 1;
+    const auto results = g2048::evaluateParallel(makePolicy, param);
+    param.numThreads = 3;
+    const auto parallelResults = g2048::evaluateParallel(makePolicy, param);
+
+    ASSERT_EQ(results.size(), param.numGames);
+    ASSERT_EQ(parallelResults.size(), param.numGames);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        EXPECT_EQ(results[i].seed, parallelResults[i].seed);
+        EXPECT_EQ(results[i].score, parallelResults[i].score);
+        EXPECT_EQ(results[i].biggestTile, parallelResults[i].biggestTile);
+        EXPECT_EQ(results[i].numMoves, parallelResults[i].numMoves);
+    }
+    EXPECT_NE(results[0].score, results[1].score);
+}
+
+TEST(Evaluation, Summary)
+{
+    std::vector<g2048::GameResult> results;
+    for (size_t i = 1; i <= 10; ++i)  // NOLINT
+    {
+        results.push_back({i, float(11 - i), i <= 3 ? 256U : 512U, 100, std::chrono::microseconds(50)});  // NOLINT
+    }
+    const auto summary = g2048::summarize(results);
+    EXPECT_EQ(summary.numGames, 10);
+    EXPECT_DOUBLE_EQ(summary.meanScore, 5.5);
+    // percentiles 0, 10, 25, 50, 75, 90, 100 of the scores 1 to 10
+    EXPECT_EQ(summary.scorePercentiles, (std::array<float, 7>{1, 1, 3, 5, 8, 9, 10}));
+    EXPECT_EQ(summary.tileCounts, (std::map<size_t, size_t>{{256, 3}, {512, 7}}));
+    EXPECT_EQ(summary.numMoves, 1000);
+    EXPECT_DOUBLE_EQ(summary.microsecondsPerMove(), 0.5);
+
+    const std::string path = testing::TempDir() + "evaluation.json";
+    ASSERT_TRUE(g2048::writeJson(path, "test", g2048::EvaluationParameter{}, summary, results));
+    std::ifstream file(path);
+    const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(json.find("\"num_games\": 10,"), std::string::npos);
+    EXPECT_NE(json.find("\"tile_counts\": {\"256\": 3, \"512\": 7}"), std::string::npos);
+
+    // names are escaped
+    ASSERT_TRUE(g2048::writeJson(path, "a \"quoted\" \\ name", g2048::EvaluationParameter{}, summary, results));
+    std::ifstream escapedFile(path);
+    const std::string escaped((std::istreambuf_iterator<char>(escapedFile)), std::istreambuf_iterator<char>());
+    EXPECT_NE(escaped.find(R"("name": "a \"quoted\" \\ name",)"), std::string::npos);
+}
+
+TEST(BatchRolloutPolicy, MatchesSingleRollouts)
+{
+    // not a multiple of the lanes, so lanes are refilled and some run empty at the end
+    constexpr size_t NUM_STATES = 1001;
+    const auto states = randomGameStates(NUM_STATES);
+    std::vector<const g2048::G2048State*> statePointers;
+    for (const auto& state : states) { statePointers.push_back(&state); }
+    g2048::G2048Problem problem{};
+
+    constexpr uint64_t SEED = 7;
+    const std::array<std::pair<size_t, float>, 2> settings{{{std::numeric_limits<size_t>::max(), 1.0f}, {10, 0.9f}}};
+    for (const auto& [depth, discount] : settings)
+    {
+        g2048::BatchRolloutPolicy batchPolicy(depth, discount, SEED);
+        std::vector<float> values(states.size());
+        batchPolicy.rolloutBatch(statePointers.data(), statePointers.size(), problem, values.data());
+
+        g2048::BatchRolloutPolicy singlePolicy(depth, discount, SEED);
+        for (size_t i = 0; i < states.size(); ++i)
+        {
+            ASSERT_FLOAT_EQ(values[i], singlePolicy.rollout(states[i], problem)) << "state " << i << "\n"
+                                                                                  << states[i].board();
+            if (problem.isTerminal(states[i])) { EXPECT_EQ(values[i], 0); }
+        }
+    }
+}
+
+TEST(BatchRolloutPolicy, Solver)
+{
+    using Solver = mcts::Solver<g2048::G2048Problem, mcts::UCB1SelectionPolicy<float>, g2048::BatchRolloutPolicy>;
+    static_assert(mcts::detail::HAS_ROLLOUT_BATCH<g2048::BatchRolloutPolicy, g2048::G2048Problem>);
+    static_assert(!mcts::detail::HAS_ROLLOUT_BATCH<mcts::RandomRolloutPolicy, g2048::G2048Problem>);
+
+    Solver solver(mcts::UCB1SelectionPolicy<float>({0, 5000, 5}), g2048::BatchRolloutPolicy{});  // NOLINT
+    solver.parameter().numIterations = 200;                                                   // NOLINT
+    g2048::G2048Problem problem{};
+    g2048::G2048State state{};
+    problem.performRandomChanceEvent(state);
+    state.setNextChance(true);
+    problem.performRandomChanceEvent(state);
+
+    const auto action = solver.run(problem, state);
+    const auto actions = problem.getAvailableActions(state);
+    EXPECT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+    EXPECT_EQ(solver.currentIteration(), 200);
+}
+
+TEST(Solver, ShareAfterstates)
+{
+    using Solver = mcts::Solver<g2048::G2048Problem>;
+    static_assert(mcts::detail::IS_HASHABLE<g2048::G2048State>);
+
+    Solver solver{};
+    solver.parameter().numIterations = 2000;  // NOLINT
+    solver.parameter().shareAfterstates = true;
+    solver.seed(1);
+    g2048::G2048Problem problem(1);
+    const auto state = randomGameStates(20).back();  // NOLINT
+    ASSERT_FALSE(state.isChanceNext());
+
+    const auto action = solver.run(problem, state);
+    const auto actions = problem.getAvailableActions(state);
+    EXPECT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+
+    const auto& tree = solver.tree();
+    std::unordered_set<g2048::G2048State> afterstates;
+    for (const auto& node : tree)
+    {
+        if (node.isChance()) { EXPECT_TRUE(afterstates.insert(node.state).second) << "afterstate is not shared"; }
+    }
+
+    size_t numLinks = 0;
+    for (size_t edgeId = 0; edgeId < tree.edges().size(); ++edgeId)
+    {
+        const auto& edge = tree.edges()[edgeId];
+        if (!edge.linked) { continue; }
+        numLinks++;
+        // the offset maps the stored node value of the shared node to the value along the path of the link
+        const auto& parent = tree[edge.parent];
+        auto afterstate = parent.state;
+        const float reward = problem.performAction(std::get<0>(parent.payload).actions[edge.index], afterstate);
+        EXPECT_EQ(afterstate, tree[edge.child].state);
+        EXPECT_FLOAT_EQ(tree[edge.child].nodeValue + tree.offset(Solver::TreeType::EdgeId{uint32_t(edgeId)}),
+                        parent.nodeValue + reward);
+    }
+    EXPECT_GT(numLinks, 0);
+    EXPECT_EQ(tree.nodeCount() + numLinks, tree.edges().size() + 1);
+}
+
+TEST(Solver, FactoredLazyChanceExpansion)
+{
+    using Solver = mcts::Solver<g2048::G2048Problem, mcts::UCB1SelectionPolicy<float>, g2048::BatchRolloutPolicy>;
+    const auto state = randomGameStates(20).back();  // NOLINT
+    ASSERT_FALSE(state.isChanceNext());
+
+    const g2048::G2048Problem problem(1, g2048::ChanceMode::FACTORED);
+    Solver solver(mcts::UCB1SelectionPolicy<float>({0, 5000, 5}), g2048::BatchRolloutPolicy{});  // NOLINT
+    solver.parameter().numIterations = 1000;                                                   // NOLINT
+    solver.parameter().lazyChanceExpansion = true;
+    solver.seed(1);
+
+    const auto action = solver.run(problem, state);
+    const auto actions = problem.getAvailableActions(state);
+    EXPECT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+
+    // every iteration adds at most all actions of a decision node or a single chance outcome
+    EXPECT_LE(solver.tree().nodeCount(), 1 + 1000 * g2048::G2048Problem::MAX_NUM_ACTIONS);  // NOLINT
+    for (const auto& node : solver.tree())
+    {
+        if (!node.isChance()) { continue; }
+        // the first stage chooses the cell, the second one the value
+        const bool cellChosen = node.state.spawnCell() != g2048::G2048State::NO_SPAWN_CELL;
+        const auto& events = std::get<1>(node.payload).events;
+        if (!events.empty()) { EXPECT_EQ(events.size(), cellChosen ? 2 : node.state.board().numEmpty()); }
+    }
+}
+
+/// Small network with 4-tuples, so that the tests don't need hundreds of megabytes
+g2048::NTupleNetwork smallNetwork()
+{
+    return g2048::NTupleNetwork({{0, 1, 2, 3}, {4, 5, 6, 7}, {0, 1, 4, 5}, {5, 6, 9, 10}});  // NOLINT
+}
+
+/// Board with 16 distinct tiles, so that no two symmetries of a tuple read the same weight
+g2048::Board distinctBoard()
+{
+    return g2048::Board({{{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}, {12, 13, 14, 15}}});  // NOLINT
+}
+
+TEST(NTupleNetwork, Update)
+{
+    auto network = smallNetwork();
+    EXPECT_EQ(network.numWeights(), 4 * 16 * 16 * 16 * 16);
+    EXPECT_EQ(network.value(distinctBoard()), 0);
+
+    constexpr float DELTA = 3.0f;
+    network.update(distinctBoard(), DELTA);
+    EXPECT_FLOAT_EQ(network.value(distinctBoard()), DELTA);
+}
+
+TEST(NTupleNetwork, Symmetric)
+{
+    auto network = smallNetwork();
+    const auto states = randomGameStates(200);  // NOLINT
+    for (const auto& state : states) { network.update(state.board(), float(state.board().biggestTile())); }
+
+    for (const auto& state : states)
+    {
+        const uint64_t raw = state.board().raw();
+        for (const uint64_t symmetric :
+             {g2048::bits::transpose(raw), g2048::bits::mirrorHorizontal(raw), g2048::bits::mirrorVertical(raw)})
+        {
+            const g2048::Board board = boardFromRaw(symmetric);
+            EXPECT_FLOAT_EQ(network.value(board), network.value(state.board())) << state.board() << board;
+        }
+    }
+}
+
+TEST(NTupleNetwork, SaveAndLoad)
+{
+    auto network = smallNetwork();
+    const auto states = randomGameStates(100);  // NOLINT
+    for (const auto& state : states) { network.update(state.board(), float(state.board().numEmpty())); }
+
+    const std::string path = testing::TempDir() + "ntuple_weights.bin";
+    ASSERT_TRUE(network.save(path));
+    auto loaded = g2048::NTupleNetwork::load(path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->tuples(), network.tuples());
+    for (const auto& state : states) { EXPECT_EQ(loaded->value(state.board()), network.value(state.board())); }
+
+    // the mapping is private, training the loaded network does not change the file
+    loaded->update(distinctBoard(), 1.0f);
+    EXPECT_EQ(g2048::NTupleNetwork::load(path)->value(distinctBoard()), network.value(distinctBoard()));
+    // but it can be saved to the file it was loaded from
+    ASSERT_TRUE(loaded->save(path));
+    EXPECT_EQ(g2048::NTupleNetwork::load(path)->value(distinctBoard()), loaded->value(distinctBoard()));
+
+    EXPECT_FALSE(g2048::NTupleNetwork::load(testing::TempDir() + "does_not_exist.bin").has_value());
+    std::ofstream(path) << "no weight file";
+    EXPECT_FALSE(g2048::NTupleNetwork::load(path).has_value());
+}
+
+TEST(NTupleNetwork, TrainingGame)
+{
+    auto network = smallNetwork();
+    g2048::G2048Problem problem(42);  // NOLINT
+    std::vector<g2048::TDTarget> targets;
+    const float score = g2048::playTrainingGame(network, problem, targets);
+
+    // with zero weights the targets are the rewards of the next move, the last afterstate has no future
+    ASSERT_FALSE(targets.empty());
+    EXPECT_EQ(targets.back().target, 0);
+    float sum = 0;
+    for (const auto& [afterstate, target] : targets)
+    {
+        EXPECT_GE(target, 0);
+        sum += target;
+    }
+    // the reward of the first move is not a target of any afterstate
+    EXPECT_LE(sum, score);
+
+    // small steps towards the non negative targets keep the values positive on average
+    constexpr float LEARNING_RATE = 0.01f;
+    float valueSum = 0;
+    for (const auto& [afterstate, target] : targets)
+    {
+        network.update(afterstate, LEARNING_RATE * (target - network.value(afterstate)));
+    }
+    for (const auto& [afterstate, target] : targets) { valueSum += network.value(afterstate); }
+    EXPECT_GT(valueSum, 0);
+}
+
+TEST(NTupleRolloutPolicy, Solver)
+{
+    auto network = std::make_shared<g2048::NTupleNetwork>(smallNetwork());
+    g2048::G2048Problem problem(42);  // NOLINT
+    std::vector<g2048::TDTarget> targets;
+    for (size_t game = 0; game < 10; ++game)  // NOLINT
+    {
+        (void)g2048::playTrainingGame(*network, problem, targets);
+        for (const auto& [afterstate, target] : targets)
+        {
+            network->update(afterstate, 0.1f * (target - network->value(afterstate)));  // NOLINT
+        }
+        targets.clear();
+    }
+
+    using Solver = mcts::Solver<g2048::G2048Problem, mcts::UCB1SelectionPolicy<float>, g2048::NTupleRolloutPolicy>;
+    Solver solver(mcts::UCB1SelectionPolicy<float>({0, 5000, 5}), g2048::NTupleRolloutPolicy{network});  // NOLINT
+    solver.parameter().numIterations = 200;                                                                 // NOLINT
+    for (const auto& state : randomGameStates(50))  // NOLINT
+    {
+        if (state.isChanceNext() || problem.isTerminal(state)) { continue; }
+        const auto action = solver.run(problem, state);
+        const auto actions = problem.getAvailableActions(state);
+        EXPECT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+
+        const g2048::NTupleRolloutPolicy policy{network};
+        const auto best = g2048::bestAfterstate(*network, state);
+        ASSERT_TRUE(best.has_value());
+        EXPECT_FLOAT_EQ(policy.rollout(state, problem), best->second);
+    }
+}
+
 struct TestData
 {
     std::array<std::array<uint8_t, 4>, 4> source;
@@ -93,3 +839,76 @@ INSTANTIATE_TEST_SUITE_P(
                                             {0, 2, 4, 8}}}}}));
 
 // clang-format on
+
+struct NumEmptyHeuristic
+{
+    float operator()(const g2048::G2048State& state, const g2048::G2048Problem& /*problem*/) const
+    {
+        return float(state.board().numEmpty());
+    }
+};
+
+struct BoardKey
+{
+    uint64_t operator()(const g2048::G2048State& state) const { return state.board().raw(); }
+};
+
+TEST(Expectimax, CacheDoesNotChangeResult)
+{
+    using Solver = mcts::ExpectimaxSolver<g2048::G2048Problem, NumEmptyHeuristic, BoardKey>;
+    g2048::G2048Problem problem{};
+    for (const auto& state : randomGameStates(40))  // NOLINT
+    {
+        if (problem.getNextStageType(state) != mcts::StageType::DECISION || problem.isTerminal(state)) { continue; }
+
+        Solver cached({2, 0, true});
+        Solver uncached({2, 0, false});
+        EXPECT_EQ(cached.run(problem, state), uncached.run(problem, state)) << state.board();
+        EXPECT_FLOAT_EQ(cached.rootValue(), uncached.rootValue()) << state.board();
+        EXPECT_LE(cached.statistics().numNodes, uncached.statistics().numNodes);
+        EXPECT_EQ(uncached.statistics().numCacheLookups, 0);
+    }
+}
+
+struct CanonicalBoardKey
+{
+    uint64_t operator()(const g2048::G2048State& state) const { return state.board().canonical().raw(); }
+};
+
+TEST(Expectimax, CanonicalKeys)
+{
+    g2048::G2048Problem problem{};
+    size_t hits = 0;
+    size_t canonicalHits = 0;
+    for (const auto& state : randomGameStates(100))  // NOLINT
+    {
+        if (problem.getNextStageType(state) != mcts::StageType::DECISION || problem.isTerminal(state)) { continue; }
+
+        // the heuristic is symmetric, so symmetric boards have exactly the same value
+        mcts::ExpectimaxSolver<g2048::G2048Problem, NumEmptyHeuristic, BoardKey> solver({2, 0, true});
+        mcts::ExpectimaxSolver<g2048::G2048Problem, NumEmptyHeuristic, CanonicalBoardKey> canonical({2, 0, true});
+        (void)solver.run(problem, state);
+        (void)canonical.run(problem, state);
+        EXPECT_NEAR(canonical.rootValue(), solver.rootValue(), 1e-4 * solver.rootValue()) << state.board();
+        EXPECT_GE(canonical.statistics().numCacheHits, solver.statistics().numCacheHits);
+        hits += solver.statistics().numCacheHits;
+        canonicalHits += canonical.statistics().numCacheHits;
+    }
+    EXPECT_GT(canonicalHits, hits);
+}
+
+TEST(Expectimax, ProbabilityCutoff)
+{
+    using Solver = mcts::ExpectimaxSolver<g2048::G2048Problem, NumEmptyHeuristic, BoardKey>;
+    g2048::G2048Problem problem{};
+    const auto states = randomGameStates(100);  // NOLINT
+    const auto state = *std::find_if(states.rbegin(), states.rend(), [&problem](const auto& s) {
+        return problem.getNextStageType(s) == mcts::StageType::DECISION && !problem.isTerminal(s);
+    });
+
+    Solver full({3, 0, true});
+    Solver pruned({3, 0.05f, true});  // NOLINT
+    (void)full.run(problem, state);
+    (void)pruned.run(problem, state);
+    EXPECT_LT(pruned.statistics().numNodes, full.statistics().numNodes);
+}
@@ -0,0 +1,163 @@
+#include "2048.h"
+#include "ntuple.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t DEFAULT_NUM_GAMES = 100000;
+constexpr float DEFAULT_LEARNING_RATE = 0.1f;
+/// games every thread plays with the same weights before the collected updates are applied
+constexpr size_t GAMES_PER_ROUND = 2;
+constexpr size_t REPORT_INTERVAL = 1000;
+
+int usage()
+{
+    std::cerr << "Usage: train_ntuple <weight file> [num games] [learning rate]\n";
+    return 1;
+}
+
+/// the number of games to train, which has to be a positive number
+std::optional<size_t> parseNumGames(const std::string& text)
+{
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); }))
+    {
+        return std::nullopt;
+    }
+    try
+    {
+        const size_t numGames = std::stoul(text);
+        if (numGames > 0) { return numGames; }
+    }
+    catch (const std::out_of_range&)
+    {
+    }
+    return std::nullopt;
+}
+
+/// the learning rate, which has to be a positive and finite number
+std::optional<float> parseLearningRate(const std::string& text)
+{
+    try
+    {
+        size_t parsed = 0;
+        const float learningRate = std::stof(text, &parsed);
+        if (parsed == text.size() && std::isfinite(learningRate) && learningRate > 0) { return learningRate; }
+    }
+    catch (const std::logic_error&)  // std::invalid_argument or std::out_of_range
+    {
+    }
+    return std::nullopt;
+}
+
+/**
+ * Offline TD(0) training of the afterstate values by self-play. The threads play games with read-only weights and
+ * collect the TD targets, which are applied by the main thread after every round. This keeps the weights free of data
+ * races at the cost of slightly outdated targets.
+ *
+ * Usage: train_ntuple <weight file> [num games] [learning rate]. Training continues from the weight file if it exists.
+ */
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> args(argv + 1, argv + argc);  // NOLINT
+    if (args.empty() || args.size() > 3) { return usage(); }
+
+    const std::string& path = args[0];
+    size_t numGames = DEFAULT_NUM_GAMES;
+    float learningRate = DEFAULT_LEARNING_RATE;
+    if (args.size() > 1)
+    {
+        const auto parsed = parseNumGames(args[1]);
+        if (!parsed)
+        {
+            std::cerr << "Invalid number of games: " << args[1] << "\n";
+            return usage();
+        }
+        numGames = *parsed;
+    }
+    if (args.size() > 2)
+    {
+        const auto parsed = parseLearningRate(args[2]);
+        if (!parsed)
+        {
+            std::cerr << "Invalid learning rate: " << args[2] << "\n";
+            return usage();
+        }
+        learningRate = *parsed;
+    }
+    const size_t numThreads = std::max(1U, std::thread::hardware_concurrency());
+
+    auto loaded = g2048::NTupleNetwork::load(path);
+    if (loaded) { std::cout << "Continuing training of " << path << "\n"; }
+    g2048::NTupleNetwork network = loaded ? std::move(*loaded) : g2048::NTupleNetwork{};
+    std::cout << "Training " << network.numWeights() << " weights with " << numThreads << " threads" << std::endl;
+
+    std::random_device seeds{};
+    std::vector<g2048::G2048Problem> problems;
+    for (size_t i = 0; i < numThreads; ++i) { problems.emplace_back(seeds()); }
+
+    std::vector<std::vector<g2048::TDTarget>> targets(numThreads);
+    std::vector<std::vector<float>> scores(numThreads);
+
+    size_t gamesPlayed = 0;
+    double scoreSum = 0;
+    float maxScore = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (gamesPlayed < numGames)
+    {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back([&, i]() {
+                for (size_t game = 0; game < GAMES_PER_ROUND; ++game)
+                {
+                    scores[i].push_back(g2048::playTrainingGame(network, problems[i], targets[i]));
+                }
+            });
+        }
+        for (auto& thread : threads) { thread.join(); }
+
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            for (const auto& [afterstate, target] : targets[i])
+            {
+                network.update(afterstate, learningRate * (target - network.value(afterstate)));
+            }
+            targets[i].clear();
+
+            for (const float score : scores[i])
+            {
+                scoreSum += score;
+                maxScore = std::max(maxScore, score);
+                if (++gamesPlayed % REPORT_INTERVAL == 0)
+                {
+                    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+                    std::cout << std::setw(8) << gamesPlayed << " games: mean score " << std::fixed
+                              << std::setprecision(0) << scoreSum / REPORT_INTERVAL << ", max score " << maxScore
+                              << ", " << std::setprecision(1) << double(gamesPlayed) / elapsed.count() << " games/s"
+                              << std::endl;
+                    scoreSum = 0;
+                    maxScore = 0;
+                }
+            }
+            scores[i].clear();
+        }
+    }
+
+    if (!network.save(path))
+    {
+        std::cerr << "Could not write " << path << "\n";
+        return 1;
+    }
+    std::cout << "Saved weights to " << path << "\n";
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "connect_four.h"
+#include "mcts/rollout/random_rollout.h"
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+#include "zbo/stop_watch.h"
+
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace mcts;
+using namespace connect_four;
+
+using ConnectFourSolver =
+    mcts::Solver<ConnectFourProblem, UCB1SelectionPolicy<float>, RolloutPolicy<ConnectFourPolicy>>;
+
+constexpr size_t NUM_ROLLOUTS = 200000;
+constexpr std::array<size_t, 3> ITERATIONS = {1000, 10000, 100000};
+
+template <typename Function>
+void benchmarkRollouts(const std::string& name, Function&& rollout)
+{
+    float sum = 0;
+    zbo::StopWatch watch;
+    watch.start();
+    for (size_t i = 0; i < NUM_ROLLOUTS; ++i) { sum += rollout(); }
+    const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(watch.stop());
+
+    constexpr int NAME_WIDTH = 20;
+    std::cout << std::setw(NAME_WIDTH) << name << ": " << std::fixed << std::setprecision(0)
+              << double(NUM_ROLLOUTS) / duration.count() << " rollouts/s, mean value of the first player "
+              << std::setprecision(3) << sum / NUM_ROLLOUTS << "\n";
+}
+
+int main(int, char**)
+{
+    const ConnectFourProblem problem{};
+    const ConnectFourState root{};
+
+    std::cout << "#### Random rollouts from the empty board: " << std::endl;
+    mcts::RandomRolloutPolicy randomPolicy{};
+    benchmarkRollouts("RandomRolloutPolicy", [&]() { return randomPolicy.rollout(root, problem)[0]; });
+    RolloutPolicy<ConnectFourPolicy> policy{};
+    policy.seed(1);
+    benchmarkRollouts("ConnectFourPolicy", [&]() { return policy.rollout(root, problem)[0]; });
+
+    std::cout << "#### Search from the empty board: " << std::endl;
+    for (const size_t iterations : ITERATIONS)
+    {
+        ConnectFourSolver solver{};
+        solver.parameter().numIterations = iterations;
+        solver.seed(1);
+        zbo::StopWatch watch;
+        watch.start();
+        const auto action = solver.run(problem, root);
+        const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(watch.stop());
+
+        std::cout << std::setw(6) << iterations << " iterations: " << std::fixed << std::setprecision(0)
+                  << double(iterations) / duration.count() << " iterations/s, " << solver.tree().nodeCount()
+                  << " nodes, best action " << problem.actionToString(root, action) << "\n";
+    }
+    return 0;
+}
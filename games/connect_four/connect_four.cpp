@@ -0,0 +1,81 @@
+#include "connect_four.h"
+
+namespace connect_four {
+
+std::ostream& ConnectFourState::writeToStream(std::ostream& stream) const  // NOLINT(readability-identifier-naming)
+{
+    for (size_t row = HEIGHT; row-- > 0;)
+    {
+        for (size_t column = 0; column < WIDTH; ++column)
+        {
+            const uint64_t cell = bits::bottomCell(column) << row;
+            stream << ((board[0] & cell) != 0 ? 'X' : (board[1] & cell) != 0 ? 'O' : '.');
+        }
+        stream << "\n";
+    }
+    return mcts::State<ConnectFourState>::writeToStream(stream);
+}
+
+std::string ConnectFourProblem::actionToString(const StateType&, const ActionType& action) const  // NOLINT
+{
+    return "column " + std::to_string(int(action) + 1);
+}
+
+/**
+ * Should return a list of all possible actions for this player
+ */
+zbo::MaxSizeVector<Actions, WIDTH> ConnectFourProblem::getAvailableActions(const ConnectFourState& state) const
+{
+    zbo::MaxSizeVector<Actions, WIDTH> actions{};
+    if (isTerminal(state)) { return actions; }
+    for (uint32_t columns = state.playableColumns(); columns != 0; columns &= columns - 1)
+    {
+        actions.push_back(static_cast<Actions>(__builtin_ctz(columns)));
+    }
+    return actions;
+}
+
+/**
+ * Apply the action to the gamestate. Gamestate will be changed with this
+ */
+ConnectFourProblem::ValueVector ConnectFourProblem::performAction(const Actions action, ConnectFourState& state) const
+{
+    const uint64_t occupied = state.occupied();
+    assert((occupied & bits::topCell(action)) == 0 && "Action is not possible, because the column is full");
+    ValueVector retval{};
+
+    // adding the bottom cell carries over the stones of the column to the lowest empty cell
+    const uint64_t cell = (occupied + bits::bottomCell(action)) & bits::columnCells(action);
+    const uint8_t player = state.getCurrentPlayer();
+    state.board[player] |= cell;
+    const bool won = bits::hasFourInARow(state.board[player]);
+    state.updateRemainingActions(won);
+
+    if (won)
+    {
+        retval[player] = WIN;
+    }
+    else if (state.numRemainingActions == 0)
+    {
+        retval[0] = WIN / 2;
+        retval[1] = WIN / 2;
+    }
+    state.increasePlayer(2);
+    return retval;
+}
+
+/**
+ * Revert the action performed last on this gamestate
+ */
+void ConnectFourProblem::undoAction(const Actions action, ConnectFourState& state) const
+{
+    const uint64_t column = state.occupied() & bits::columnCells(action);
+    assert(column != 0 && "Action was not played");
+
+    const uint64_t cell = uint64_t(1) << (63 - __builtin_clzll(column));  // NOLINT
+    const uint8_t player = (state.board[0] & cell) != 0 ? 0 : 1;
+    state.setCurrentPlayer(player);
+    state.board[player] &= ~cell;
+    state.updateRemainingActions(false);
+}
+}  // namespace connect_four
@@ -0,0 +1,219 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "mcts/problem.h"
+#include "mcts/random.h"
+#include "mcts/state.h"
+#include "zbo/max_size_vector.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace connect_four {
+
+constexpr size_t WIDTH = 7;
+constexpr size_t HEIGHT = 6;
+constexpr size_t NUM_CELLS = WIDTH * HEIGHT;
+/// every column has one bit more than cells, so that lines can not wrap into the next column when shifting
+constexpr size_t COLUMN_BITS = HEIGHT + 1;
+
+constexpr float WIN = 1.0f;
+
+enum Actions : uint8_t
+{
+    COLUMN_1 = 0,
+    COLUMN_2 = 1,
+    COLUMN_3 = 2,
+    COLUMN_4 = 3,
+    COLUMN_5 = 4,
+    COLUMN_6 = 5,
+    COLUMN_7 = 6
+};
+
+/**
+ * Bitboards with one bit per cell, where bit COLUMN_BITS * column + row is the cell in the column and row (counted from
+ * the bottom). The topmost bit of each column is always empty
+ */
+namespace bits {
+constexpr uint64_t bottomCell(size_t column)
+{
+    return uint64_t(1) << (column * COLUMN_BITS);
+}
+
+constexpr uint64_t topCell(size_t column)
+{
+    return uint64_t(1) << (column * COLUMN_BITS + HEIGHT - 1);
+}
+
+constexpr uint64_t columnCells(size_t column)
+{
+    return ((uint64_t(1) << HEIGHT) - 1) << (column * COLUMN_BITS);
+}
+
+constexpr uint64_t createTopRow()
+{
+    uint64_t row = 0;
+    for (size_t column = 0; column < WIDTH; ++column) { row |= topCell(column); }
+    return row;
+}
+
+constexpr uint64_t TOP_ROW = createTopRow();
+
+/// whether the stones contain 4 in a row vertically (shift 1), horizontally (shift COLUMN_BITS) or diagonally
+constexpr bool hasFourInARow(uint64_t stones)
+{
+    for (const size_t shift : {size_t(1), COLUMN_BITS, COLUMN_BITS - 1, COLUMN_BITS + 1})
+    {
+        const uint64_t pairs = stones & (stones >> shift);
+        if ((pairs & (pairs >> (2 * shift))) != 0) { return true; }
+    }
+    return false;
+}
+}  // namespace bits
+
+class ConnectFourState : public mcts::State<ConnectFourState>
+{
+  public:
+    std::ostream& writeToStream(std::ostream& stream) const;  // NOLINT
+
+    [[nodiscard]] uint64_t occupied() const { return board[0] | board[1]; }
+
+    /// sets numRemainingActions from the empty cells, or to 0 if the last move won
+    void updateRemainingActions(bool won)
+    {
+        numRemainingActions = won ? 0 : static_cast<uint8_t>(NUM_CELLS - size_t(__builtin_popcountll(occupied())));
+    }
+
+    /// bit c is set if a stone can be dropped into column c
+    [[nodiscard]] uint32_t playableColumns() const
+    {
+        const uint64_t freeTops = ~occupied() & bits::TOP_ROW;
+#ifdef __BMI2__
+        return static_cast<uint32_t>(_pext_u64(freeTops, bits::TOP_ROW));
+#else
+        uint32_t columns = 0;
+        for (size_t column = 0; column < WIDTH; ++column)
+        {
+            if ((freeTops & bits::topCell(column)) != 0) { columns |= 1U << column; }
+        }
+        return columns;
+#endif
+    }
+
+    [[nodiscard]] bool operator==(const ConnectFourState& rhs) const
+    {
+        return board == rhs.board && getCurrentPlayer() == rhs.getCurrentPlayer();
+    }
+
+    /// stones of each player
+    std::array<uint64_t, 2> board{};
+    /// number of empty cells, 0 once a player has won
+    uint8_t numRemainingActions{NUM_CELLS};
+};
+
+struct ProblemDefinition
+{
+    using ValueType = float;
+    using ActionType = Actions;
+    using ChanceEventType = mcts::NoEvent;
+    using StateType = ConnectFourState;
+
+    static constexpr int NUM_PLAYERS = 2;
+    static constexpr int MAX_NUM_ACTIONS = WIDTH;
+    static constexpr int MAX_CHANCE_EVENTS = 0;
+
+    using ValueVector = std::array<float, NUM_PLAYERS>;
+};
+
+/**
+ * @brief Connect four on a 7x6 board: both players alternately drop a stone into one of the columns, the first one
+ * with 4 stones in a row (horizontally, vertically or diagonally) wins. Games are up to 42 moves deep with at most 7
+ * actions per move
+ */
+class ConnectFourProblem : public mcts::Problem<ConnectFourProblem, ProblemDefinition>
+{
+  public:
+    std::string actionToString(const StateType& state, const ActionType& action) const;  // NOLINT
+
+    [[nodiscard]] constexpr mcts::StageType getNextStageType(const ConnectFourState&) const
+    {
+        return mcts::StageType::DECISION;
+    }
+
+    [[nodiscard]] zbo::MaxSizeVector<Actions, WIDTH> getAvailableActions(const ConnectFourState& state) const;
+
+    ValueVector performAction(const Actions action, ConnectFourState& state) const;
+    void undoAction(const Actions action, ConnectFourState& state) const;
+
+    [[nodiscard]] bool isTerminal(const ConnectFourState& state) const { return state.numRemainingActions == 0; }
+    [[nodiscard]] bool didPlayerWin(const ConnectFourState& state, uint8_t player) const
+    {
+        return bits::hasFourInARow(state.board[player]);
+    }
+};
+
+/// Drops the stone into a random column that is not full
+class ConnectFourPolicy
+{
+  public:
+    Actions getAction(const ConnectFourState& state, const ConnectFourProblem&) const
+    {
+        assert(state.numRemainingActions > 0);
+        const uint32_t columns = state.playableColumns();
+        const auto idx = static_cast<uint32_t>(engine_() % uint32_t(__builtin_popcount(columns)));
+#ifdef __BMI2__
+        return static_cast<Actions>(__builtin_ctz(_pdep_u32(1U << idx, columns)));
+#else
+        uint32_t remaining = columns;
+        for (uint32_t i = 0; i < idx; ++i) { remaining &= remaining - 1; }
+        return static_cast<Actions>(__builtin_ctz(remaining));
+#endif
+    }
+
+    void seed(size_t seed) { engine_.seed(seed); }
+
+  private:
+    mcts::ThreadLocalEngine engine_{};
+};
+}  // namespace connect_four
+
+/// Makes the states usable as keys of transposition tables
+namespace std {
+template <>
+struct hash<connect_four::ConnectFourState>
+{
+    size_t operator()(const connect_four::ConnectFourState& state) const noexcept
+    {
+        // the stones of the first player and all stones together identify the position
+        return mcts::splitMix64(state.board[0] ^ mcts::splitMix64(state.occupied()));
+    }
+};
+}  // namespace std
@@ -0,0 +1,47 @@
+#include "connect_four.h"
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+
+#include <iostream>
+
+using namespace mcts;
+using namespace connect_four;
+
+int main(int, char**)
+{
+    ConnectFourState state;
+    ConnectFourProblem game;
+
+    while (!game.isTerminal(state))
+    {
+        state.print();
+        std::cout << "\n";
+        if (state.getCurrentPlayer() == 0)
+        {
+            auto possibleActions = game.getAvailableActions(state);
+            size_t i = 0;
+            for (auto ac : possibleActions)
+            {
+                std::cout << i << ": " << game.actionToString(state, ac) << "\n";
+                ++i;
+            }
+            std::cout << "Which Action should be performed?\n";
+            size_t actionId{};
+            std::cin >> actionId;
+            if (actionId >= possibleActions.size()) { continue; }
+            auto value = game.performAction(possibleActions[actionId], state);
+            std::cout << "Value: " << value[0] << ", " << value[1] << "\n";
+        }
+        else
+        {
+            mcts::Solver<ConnectFourProblem, UCB1SelectionPolicy<float>, RolloutPolicy<ConnectFourPolicy> > solver;
+            solver.parameter().numIterations = 100000;  // NOLINT
+            auto action = solver.run(game, state);
+            solver.printTopLevelUtilities();
+            auto value = game.performAction(action, state);
+            std::cout << "Value: " << value[0] << ", " << value[1] << "\n";
+        }
+    }
+    state.print();
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "connect_four.h"
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+#include "zbo/stop_watch.h"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+
+using namespace mcts;
+using namespace connect_four;
+
+using ConnectFourSolver =
+    mcts::Solver<ConnectFourProblem, UCB1SelectionPolicy<float>, RolloutPolicy<ConnectFourPolicy>>;
+
+/// Plays one game with a stronger (more iterations) and a weaker solver, returns the winner or -1 for a draw
+int playGame(ConnectFourSolver& strong, ConnectFourSolver& weak, uint8_t strongPlayer, size_t& mctsIterations)
+{
+    const ConnectFourProblem game{};
+    ConnectFourState state{};
+    ConnectFourProblem::ValueVector rewards{};
+    while (!game.isTerminal(state))
+    {
+        auto& solver = state.getCurrentPlayer() == strongPlayer ? strong : weak;
+        rewards = game.performAction(solver.run(game, state), state);
+        mctsIterations += solver.parameter().numIterations;
+    }
+
+    if (rewards[0] == WIN) { return 0; }
+    if (rewards[1] == WIN) { return 1; }
+    return -1;
+}
+
+int main(int, char**)
+{
+    constexpr uint32_t NUM_GAMES = 100;
+    constexpr size_t STRONG_ITERATIONS = 10000;
+    constexpr size_t WEAK_ITERATIONS = 1000;
+
+    ConnectFourSolver strong{};
+    strong.parameter().numIterations = STRONG_ITERATIONS;
+    ConnectFourSolver weak{};
+    weak.parameter().numIterations = WEAK_ITERATIONS;
+
+    uint32_t numStrongWins = 0;
+    uint32_t numWeakWins = 0;
+    uint32_t numDraws = 0;
+    size_t mctsIterations = 0;
+
+    zbo::StopWatch total;
+    total.start();
+    for (size_t i = 0; i < NUM_GAMES; ++i)
+    {
+        const auto strongPlayer = static_cast<uint8_t>(i % 2);
+        const int winner = playGame(strong, weak, strongPlayer, mctsIterations);
+        if (winner < 0) { numDraws++; }
+        else if (winner == strongPlayer)
+        {
+            numStrongWins++;
+        }
+        else
+        {
+            numWeakWins++;
+        }
+    }
+    const auto dttotal = total.stop();
+
+    std::cout << "All games took " << std::chrono::duration_cast<std::chrono::milliseconds>(dttotal).count()
+              << "ms, which is a duration of "
+              << double(std::chrono::duration_cast<std::chrono::microseconds>(dttotal).count()) /
+                     double(mctsIterations)
+              << "us per mcts iteration" << std::endl;
+
+    constexpr int PERCENT = 100;
+    std::cout << STRONG_ITERATIONS << " iterations: " << double(numStrongWins) / double(NUM_GAMES) * PERCENT << "%\n";
+    std::cout << WEAK_ITERATIONS << " iterations:  " << double(numWeakWins) / double(NUM_GAMES) * PERCENT << "%\n";
+    std::cout << "Draws:             " << double(numDraws) / double(NUM_GAMES) * PERCENT << "%\n";
+}
@@ -0,0 +1,127 @@
+#include "connect_four.h"
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+using namespace connect_four;
+
+namespace {
+void play(const ConnectFourProblem& problem, ConnectFourState& state, std::initializer_list<size_t> columns)
+{
+    for (const size_t column : columns) { problem.performAction(static_cast<Actions>(column), state); }
+}
+
+/// cell by cell search for 4 stones in a row
+bool referenceFourInARow(uint64_t stones)
+{
+    const auto stone = [stones](int column, int row) {
+        return column >= 0 && row >= 0 && column < int(WIDTH) && row < int(HEIGHT) &&
+               ((stones >> (size_t(column) * COLUMN_BITS + size_t(row))) & 1U) != 0;
+    };
+    for (int column = 0; column < int(WIDTH); ++column)
+    {
+        for (int row = 0; row < int(HEIGHT); ++row)
+        {
+            for (const auto& [dx, dy] : {std::pair{1, 0}, std::pair{0, 1}, std::pair{1, 1}, std::pair{1, -1}})
+            {
+                bool line = true;
+                for (int i = 0; i < 4; ++i) { line = line && stone(column + i * dx, row + i * dy); }
+                if (line) { return true; }
+            }
+        }
+    }
+    return false;
+}
+}  // namespace
+
+TEST(ConnectFour, Lines)
+{
+    const ConnectFourProblem problem{};
+
+    ConnectFourState vertical{};
+    play(problem, vertical, {0, 1, 0, 1, 0, 1});
+    EXPECT_FALSE(problem.isTerminal(vertical));
+    play(problem, vertical, {0});
+    EXPECT_TRUE(problem.isTerminal(vertical));
+    EXPECT_TRUE(problem.didPlayerWin(vertical, 0));
+
+    ConnectFourState horizontal{};
+    play(problem, horizontal, {3, 3, 4, 4, 5, 5});
+    const auto rewards = problem.performAction(COLUMN_7, horizontal);
+    EXPECT_EQ(rewards[0], WIN);
+    EXPECT_TRUE(problem.getAvailableActions(horizontal).empty());
+
+    // rising diagonal of the first player from column 1 to column 4
+    ConnectFourState diagonal{};
+    play(problem, diagonal, {0, 1, 1, 2, 2, 3, 2, 3, 3, 6});
+    EXPECT_FALSE(problem.isTerminal(diagonal));
+    play(problem, diagonal, {3});
+    EXPECT_TRUE(problem.didPlayerWin(diagonal, 0));
+
+    // three stones at the top of one column and one at the bottom of the next are no line
+    EXPECT_FALSE(bits::hasFourInARow((bits::columnCells(0) & ~uint64_t(0b111)) | bits::bottomCell(1)));
+    EXPECT_TRUE(bits::hasFourInARow(bits::columnCells(0) & ~uint64_t(0b11)));
+}
+
+TEST(ConnectFour, RandomGames)
+{
+    // random games with undo of every move, compared to the cell by cell reference
+    const ConnectFourProblem problem{};
+    ConnectFourPolicy policy{};
+    policy.seed(1);
+    constexpr size_t NUM_GAMES = 1000;
+    for (size_t game = 0; game < NUM_GAMES; ++game)
+    {
+        ConnectFourState state{};
+        while (!problem.isTerminal(state))
+        {
+            const auto before = state;
+            const auto actions = problem.getAvailableActions(state);
+            const auto action = policy.getAction(state, problem);
+            ASSERT_NE(std::find(actions.begin(), actions.end(), action), actions.end());
+
+            problem.performAction(action, state);
+            EXPECT_EQ(__builtin_popcountll(state.occupied()), __builtin_popcountll(before.occupied()) + 1);
+            problem.undoAction(action, state);
+            EXPECT_TRUE(state == before);
+            EXPECT_EQ(state.numRemainingActions, before.numRemainingActions);
+
+            const uint8_t player = state.getCurrentPlayer();
+            const auto rewards = problem.performAction(action, state);
+            EXPECT_EQ(problem.didPlayerWin(state, player), referenceFourInARow(state.board[player]));
+            EXPECT_EQ(rewards[player] == WIN, referenceFourInARow(state.board[player]));
+        }
+    }
+}
+
+TEST(ConnectFour, SolverBlocksWin)
+{
+    using Solver = mcts::Solver<ConnectFourProblem, mcts::UCB1SelectionPolicy<float>,
+                                mcts::RolloutPolicy<ConnectFourPolicy>>;
+    const ConnectFourProblem problem{};
+    ConnectFourState state{};
+    // the first player threatens to complete the bottom row on the left side, the right side is blocked
+    play(problem, state, {3, 6, 4, 4, 5});
+
+    Solver solver{};
+    solver.parameter().numIterations = 5000;  // NOLINT
+    solver.seed(1);
+    EXPECT_EQ(solver.run(problem, state), COLUMN_3);
+}
+
+TEST(ConnectFour, SolverFromEmptyBoard)
+{
+    using Solver = mcts::Solver<ConnectFourProblem, mcts::UCB1SelectionPolicy<float>,
+                                mcts::RolloutPolicy<ConnectFourPolicy>>;
+    const ConnectFourProblem problem{};
+    Solver solver{};
+    solver.parameter().numIterations = 10000;  // NOLINT
+    solver.seed(1);
+
+    // the middle column is the best first move. All expansions add the maximal number of children here
+    EXPECT_EQ(solver.run(problem, ConnectFourState{}), COLUMN_4);
+    EXPECT_LE(solver.tree().nodeCount(), solver.tree().capacity());
+}
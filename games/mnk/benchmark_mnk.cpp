@@ -0,0 +1,63 @@
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+#include "mnk.h"
+#include "zbo/stop_watch.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace mcts;
+using namespace mnk;
+
+constexpr size_t NUM_ITERATIONS = 200;
+constexpr size_t NUM_ROLLOUTS = 20000;
+
+/// Speed of the search from the empty board and size of the resulting tree for growing boards
+template <size_t M, size_t N, size_t K>
+void benchmark(const std::string& name)
+{
+    using Problem = MNKProblem<M, N, K>;
+    using Policy = RolloutPolicy<MNKRandomPolicy<M, N, K>>;
+    using Solver = mcts::Solver<Problem, UCB1SelectionPolicy<float>, Policy>;
+
+    const Problem problem{};
+    const typename Problem::StateType root{};
+
+    Policy policy{};
+    policy.seed(1);
+    zbo::StopWatch rolloutWatch;
+    rolloutWatch.start();
+    float sum = 0;
+    for (size_t i = 0; i < NUM_ROLLOUTS; ++i) { sum += policy.rollout(root, problem)[0]; }
+    const auto rolloutDuration = std::chrono::duration_cast<std::chrono::duration<double>>(rolloutWatch.stop());
+
+    Solver solver{};
+    solver.parameter().numIterations = NUM_ITERATIONS;
+    solver.seed(1);
+    zbo::StopWatch searchWatch;
+    searchWatch.start();
+    (void)solver.run(problem, root);
+    const auto searchDuration = std::chrono::duration_cast<std::chrono::duration<double>>(searchWatch.stop());
+
+    constexpr int NAME_WIDTH = 12;
+    constexpr double MEGABYTE = 1024.0 * 1024.0;
+    const size_t numNodes = solver.tree().nodeCount();
+    std::cout << std::left << std::setw(NAME_WIDTH) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << double(NUM_ROLLOUTS) / rolloutDuration.count() << " rollouts/s, " << std::setw(8)
+              << double(NUM_ITERATIONS) / searchDuration.count() << " iterations/s, " << std::setw(8) << numNodes
+              << " nodes of " << sizeof(typename Solver::Node) << " bytes (" << std::setprecision(1)
+              << double(numNodes * sizeof(typename Solver::Node)) / MEGABYTE << " MB), mean value of the first player "
+              << std::setprecision(3) << sum / NUM_ROLLOUTS << " in random games\n";
+}
+
+int main(int, char**)
+{
+    std::cout << "#### Random rollouts and " << NUM_ITERATIONS << " iterations from the empty board: " << std::endl;
+    benchmark<3, 3, 3>("3,3,3");
+    benchmark<7, 7, 4>("7,7,4");
+    benchmark<9, 9, 5>("9,9,5");
+    benchmark<15, 15, 5>("Gomoku");
+    return 0;
+}
@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace mnk {
+
+/// Set of cells of a board with NUM_CELLS cells, stored as bits in 64 bit words
+template <size_t NUM_CELLS>
+class Bitboard
+{
+  public:
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t NUM_WORDS = (NUM_CELLS + WORD_BITS - 1) / WORD_BITS;
+
+    /// bitboard with all cells set
+    static constexpr Bitboard full()
+    {
+        Bitboard board{};
+        for (size_t word = 0; word < NUM_WORDS; ++word) { board.words_[word] = ~uint64_t(0); }
+        if constexpr (NUM_CELLS % WORD_BITS != 0)
+        {
+            board.words_[NUM_WORDS - 1] = (uint64_t(1) << (NUM_CELLS % WORD_BITS)) - 1;
+        }
+        return board;
+    }
+
+    constexpr void set(size_t cell) { words_[cell / WORD_BITS] |= bit(cell); }
+    constexpr void reset(size_t cell) { words_[cell / WORD_BITS] &= ~bit(cell); }
+    [[nodiscard]] constexpr bool test(size_t cell) const { return (words_[cell / WORD_BITS] & bit(cell)) != 0; }
+
+    [[nodiscard]] size_t count() const
+    {
+        size_t count = 0;
+        for (const uint64_t word : words_) { count += size_t(__builtin_popcountll(word)); }
+        return count;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        for (const uint64_t word : words_)
+        {
+            if (word != 0) { return false; }
+        }
+        return true;
+    }
+
+    /// the n-th (starting at 0) set cell in ascending order, there have to be more than n set cells
+    [[nodiscard]] size_t nth(size_t n) const
+    {
+        for (size_t word = 0; word < NUM_WORDS; ++word)
+        {
+            const auto numSet = size_t(__builtin_popcountll(words_[word]));
+            if (n >= numSet)
+            {
+                n -= numSet;
+                continue;
+            }
+#ifdef __BMI2__
+            return word * WORD_BITS + size_t(__builtin_ctzll(_pdep_u64(uint64_t(1) << n, words_[word])));
+#else
+            uint64_t remaining = words_[word];
+            for (size_t i = 0; i < n; ++i) { remaining &= remaining - 1; }
+            return word * WORD_BITS + size_t(__builtin_ctzll(remaining));
+#endif
+        }
+        assert(false && "Not enough cells set");
+        return NUM_CELLS;
+    }
+
+    /// calls the visitor with every set cell in ascending order
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) const
+    {
+        for (size_t word = 0; word < NUM_WORDS; ++word)
+        {
+            for (uint64_t bits = words_[word]; bits != 0; bits &= bits - 1)
+            {
+                visitor(word * WORD_BITS + size_t(__builtin_ctzll(bits)));
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr Bitboard operator|(const Bitboard& other) const
+    {
+        Bitboard result{};
+        for (size_t word = 0; word < NUM_WORDS; ++word) { result.words_[word] = words_[word] | other.words_[word]; }
+        return result;
+    }
+
+    /// cells of this board that are not set in the other one
+    [[nodiscard]] constexpr Bitboard without(const Bitboard& other) const
+    {
+        Bitboard result{};
+        for (size_t word = 0; word < NUM_WORDS; ++word) { result.words_[word] = words_[word] & ~other.words_[word]; }
+        return result;
+    }
+
+    [[nodiscard]] bool operator==(const Bitboard& other) const { return words_ == other.words_; }
+    [[nodiscard]] constexpr const std::array<uint64_t, NUM_WORDS>& words() const { return words_; }
+
+  private:
+    static constexpr uint64_t bit(size_t cell) { return uint64_t(1) << (cell % WORD_BITS); }
+
+    std::array<uint64_t, NUM_WORDS> words_{};
+};
+}  // namespace mnk
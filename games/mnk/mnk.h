@@ -0,0 +1,253 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "bitboard.h"
+#include "mcts/problem.h"
+#include "mcts/random.h"
+#include "mcts/state.h"
+#include "zbo/max_size_vector.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace mnk {
+
+constexpr float WIN = 1.0f;
+
+/// Places a stone on the cell y * M + x of a board with M columns
+template <size_t M>
+struct Move
+{
+    uint8_t cell{};
+
+    [[nodiscard]] constexpr size_t x() const { return cell % M; }
+    [[nodiscard]] constexpr size_t y() const { return cell / M; }
+
+    [[nodiscard]] constexpr bool operator==(const Move& other) const { return cell == other.cell; }
+    [[nodiscard]] constexpr bool operator<(const Move& other) const { return cell < other.cell; }
+};
+
+template <size_t M>
+std::string to_string(Move<M> move)  // NOLINT
+{
+    return "(" + std::to_string(move.x()) + ", " + std::to_string(move.y()) + ")";
+}
+
+template <size_t M>
+std::ostream& operator<<(std::ostream& stream, Move<M> move)
+{
+    return stream << to_string(move);
+}
+
+/// Board with M columns and N rows, stored as one bitboard per player
+template <size_t M, size_t N>
+class MNKState : public mcts::State<MNKState<M, N>>
+{
+  public:
+    static constexpr size_t NUM_CELLS = M * N;
+    using Board = Bitboard<NUM_CELLS>;
+
+    std::ostream& writeToStream(std::ostream& stream) const
+    {
+        for (size_t y = 0; y < N; ++y)
+        {
+            for (size_t x = 0; x < M; ++x)
+            {
+                const size_t cell = y * M + x;
+                stream << (board[0].test(cell) ? 'X' : board[1].test(cell) ? 'O' : '.');
+            }
+            stream << "\n";
+        }
+        return mcts::State<MNKState<M, N>>::writeToStream(stream);
+    }
+
+    [[nodiscard]] Board occupied() const { return board[0] | board[1]; }
+    [[nodiscard]] Board empty() const { return Board::full().without(occupied()); }
+
+    /// sets numRemainingActions from the empty cells, or to 0 if the last move won
+    void updateRemainingActions(bool won)
+    {
+        numRemainingActions = won ? 0 : static_cast<uint16_t>(NUM_CELLS - occupied().count());
+    }
+
+    [[nodiscard]] bool operator==(const MNKState& rhs) const
+    {
+        return board == rhs.board && this->getCurrentPlayer() == rhs.getCurrentPlayer();
+    }
+
+    /// cells of each player
+    std::array<Board, 2> board{};
+    /// number of empty cells, 0 once a player has won
+    uint16_t numRemainingActions{NUM_CELLS};
+};
+
+template <size_t M, size_t N>
+struct ProblemDefinition
+{
+    using ValueType = float;
+    using ActionType = Move<M>;
+    using ChanceEventType = mcts::NoEvent;
+    using StateType = MNKState<M, N>;
+
+    static constexpr int NUM_PLAYERS = 2;
+    static constexpr int MAX_NUM_ACTIONS = M * N;
+    static constexpr int MAX_CHANCE_EVENTS = 0;
+
+    using ValueVector = std::array<float, NUM_PLAYERS>;
+};
+
+/**
+ * @brief m,n,k-game: two players alternately place stones on a board with M columns and N rows, the first one with K
+ * stones in a row (horizontally, vertically or diagonally) wins. Tic-tac-toe is the 3,3,3-game and Gomoku the
+ * 15,15,5-game, which reaches the branching factor of real board games.
+ * Only the lines through the last stone are checked for a win, so the cost of a move does not grow with the board
+ */
+template <size_t M, size_t N, size_t K>
+class MNKProblem : public mcts::Problem<MNKProblem<M, N, K>, ProblemDefinition<M, N>>
+{
+  public:
+    using Definition = ProblemDefinition<M, N>;
+    using ValueVector = typename Definition::ValueVector;
+    using StateType = typename Definition::StateType;
+    using ActionType = typename Definition::ActionType;
+
+    static constexpr size_t NUM_CELLS = M * N;
+    static_assert(K <= M || K <= N, "K stones in a row do not fit on the board");
+    static_assert(NUM_CELLS <= std::numeric_limits<uint8_t>::max() + 1, "Move stores the cell index in 8 bits");
+
+    [[nodiscard]] constexpr mcts::StageType getNextStageType(const StateType&) const
+    {
+        return mcts::StageType::DECISION;
+    }
+
+    /**
+     * Should return a list of all possible actions for this player
+     */
+    [[nodiscard]] zbo::MaxSizeVector<ActionType, NUM_CELLS> getAvailableActions(const StateType& state) const
+    {
+        zbo::MaxSizeVector<ActionType, NUM_CELLS> actions{};
+        if (state.numRemainingActions == 0) { return actions; }
+        state.empty().forEach([&actions](size_t cell) { actions.push_back(ActionType{static_cast<uint8_t>(cell)}); });
+        return actions;
+    }
+
+    /**
+     * Apply the action to the gamestate. Gamestate will be changed with this
+     */
+    ValueVector performAction(const ActionType action, StateType& state) const
+    {
+        assert(!state.occupied().test(action.cell) && "Action is not possible, because already played");
+        assert(state.numRemainingActions > 0 && "Action is not possible, because the game is over");
+        ValueVector retval{};
+
+        const uint8_t player = state.getCurrentPlayer();
+        state.board[player].set(action.cell);
+        const bool won = completesLine(state.board[player], action);
+        state.updateRemainingActions(won);
+
+        if (won)
+        {
+            retval[player] = WIN;
+        }
+        else if (state.numRemainingActions == 0)
+        {
+            retval[0] = WIN / 2;
+            retval[1] = WIN / 2;
+        }
+        state.increasePlayer(2);
+        return retval;
+    }
+
+    /**
+     * Revert the action performed last on this gamestate
+     */
+    void undoAction(const ActionType action, StateType& state) const
+    {
+        assert(state.occupied().test(action.cell) && "Action was not played");
+
+        const uint8_t player = state.board[0].test(action.cell) ? 0 : 1;
+        state.setCurrentPlayer(player);
+        state.board[player].reset(action.cell);
+        state.updateRemainingActions(false);
+    }
+
+    [[nodiscard]] bool isTerminal(const StateType& state) const { return state.numRemainingActions == 0; }
+
+    /// whether the stones of the player contain K in a row that goes through the cell of the move
+    [[nodiscard]] static bool completesLine(const typename StateType::Board& stones, ActionType move)
+    {
+        constexpr std::array<std::array<int, 2>, 4> DIRECTIONS{{{1, 0}, {0, 1}, {1, 1}, {1, -1}}};
+        for (const auto& [dx, dy] : DIRECTIONS)
+        {
+            const size_t length = 1 + countStones(stones, move, dx, dy) + countStones(stones, move, -dx, -dy);
+            if (length >= K) { return true; }
+        }
+        return false;
+    }
+
+  private:
+    /// number of consecutive stones next to the cell of the move in the direction, at most K - 1
+    static size_t countStones(const typename StateType::Board& stones, ActionType move, int dx, int dy)
+    {
+        auto x = int(move.x());
+        auto y = int(move.y());
+        size_t count = 0;
+        while (count + 1 < K)
+        {
+            x += dx;
+            y += dy;
+            if (x < 0 || y < 0 || x >= int(M) || y >= int(N) || !stones.test(size_t(y) * M + size_t(x))) { break; }
+            count++;
+        }
+        return count;
+    }
+};
+
+/// Plays a random empty cell
+template <size_t M, size_t N, size_t K>
+class MNKRandomPolicy
+{
+  public:
+    using Problem = MNKProblem<M, N, K>;
+
+    typename Problem::ActionType getAction(const typename Problem::StateType& state, const Problem&) const
+    {
+        assert(state.numRemainingActions > 0);
+        const size_t idx = engine_() % state.numRemainingActions;
+        return typename Problem::ActionType{static_cast<uint8_t>(state.empty().nth(idx))};
+    }
+
+    void seed(size_t seed) { engine_.seed(seed); }
+
+  private:
+    mcts::ThreadLocalEngine engine_{};
+};
+
+using Gomoku = MNKProblem<15, 15, 5>;             // NOLINT
+using GomokuPolicy = MNKRandomPolicy<15, 15, 5>;  // NOLINT
+}  // namespace mnk
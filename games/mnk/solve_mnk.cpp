@@ -0,0 +1,71 @@
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+#include "mnk.h"
+#include "zbo/stop_watch.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace mcts;
+using namespace mnk;
+
+using GomokuSolver = mcts::Solver<Gomoku, UCB1SelectionPolicy<float>, RolloutPolicy<GomokuPolicy>>;
+
+/// Plays one game of Gomoku with the solver for both players, returns the winner or -1 for a draw
+int playGomoku(GomokuSolver& solver, size_t& numMoves)
+{
+    const Gomoku game{};
+    Gomoku::StateType state{};
+    Gomoku::ValueVector rewards{};
+    while (!game.isTerminal(state))
+    {
+        rewards = game.performAction(solver.run(game, state), state);
+        numMoves++;
+    }
+    state.print();
+
+    if (rewards[0] == WIN) { return 0; }
+    if (rewards[1] == WIN) { return 1; }
+    return -1;
+}
+
+int main(int, char**)
+{
+    constexpr uint32_t NUM_GAMES = 2;
+    constexpr size_t ITERATIONS_PER_MOVE = 200;
+
+    GomokuSolver solver{};
+    solver.parameter().numIterations = ITERATIONS_PER_MOVE;
+
+    std::array<uint32_t, 2> numWins{};
+    uint32_t numDraws = 0;
+    size_t numMoves = 0;
+
+    zbo::StopWatch total;
+    total.start();
+    for (size_t i = 0; i < NUM_GAMES; ++i)
+    {
+        zbo::StopWatch game;
+        game.start();
+        const int winner = playGomoku(solver, numMoves);
+        if (winner < 0) { numDraws++; }
+        else
+        {
+            numWins.at(size_t(winner))++;
+        }
+        std::cout << "Game # " << i << " took "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(game.stop()).count() << "ms" << std::endl;
+    }
+    const auto dttotal = total.stop();
+
+    std::cout << "All games took " << std::chrono::duration_cast<std::chrono::milliseconds>(dttotal).count()
+              << "ms with " << numMoves << " moves, which is a duration of "
+              << double(std::chrono::duration_cast<std::chrono::microseconds>(dttotal).count()) /
+                     double(numMoves * ITERATIONS_PER_MOVE)
+              << "us per mcts iteration" << std::endl;
+
+    constexpr int PERCENT = 100;
+    std::cout << "Player 1: " << double(numWins[0]) / double(NUM_GAMES) * PERCENT << "%\n";
+    std::cout << "Player 2: " << double(numWins[1]) / double(NUM_GAMES) * PERCENT << "%\n";
+    std::cout << "Draws:    " << double(numDraws) / double(NUM_GAMES) * PERCENT << "%\n";
+}
@@ -0,0 +1,136 @@
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+#include "mnk.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <utility>
+
+using namespace mnk;
+
+namespace {
+/// plays the given (x, y) moves and returns the rewards of the last one
+template <size_t M, size_t N, size_t K>
+typename MNKProblem<M, N, K>::ValueVector play(const MNKProblem<M, N, K>& problem, MNKState<M, N>& state,
+                                               std::initializer_list<std::array<size_t, 2>> moves)
+{
+    typename MNKProblem<M, N, K>::ValueVector rewards{};
+    for (const auto& [x, y] : moves)
+    {
+        rewards = problem.performAction(Move<M>{static_cast<uint8_t>(y * M + x)}, state);
+    }
+    return rewards;
+}
+}  // namespace
+
+TEST(Bitboard, Cells)
+{
+    constexpr size_t NUM_CELLS = 225;
+    Bitboard<NUM_CELLS> board{};
+    EXPECT_TRUE(board.empty());
+    EXPECT_EQ(Bitboard<NUM_CELLS>::full().count(), NUM_CELLS);
+
+    const std::array<size_t, 5> cells{3, 63, 64, 130, 224};
+    for (const size_t cell : cells) { board.set(cell); }
+    EXPECT_EQ(board.count(), cells.size());
+    for (size_t i = 0; i < cells.size(); ++i) { EXPECT_EQ(board.nth(i), cells.at(i)); }
+
+    std::vector<size_t> visited;
+    board.forEach([&visited](size_t cell) { visited.push_back(cell); });
+    EXPECT_TRUE(std::equal(visited.begin(), visited.end(), cells.begin(), cells.end()));
+
+    board.reset(64);
+    EXPECT_FALSE(board.test(64));
+    EXPECT_EQ(Bitboard<NUM_CELLS>::full().without(board).count(), NUM_CELLS - cells.size() + 1);
+}
+
+TEST(MNKProblem, TicTacToeStates)
+{
+    // the 3,3,3-game has the same positions as tic-tac-toe
+    const MNKProblem<3, 3, 3> problem{};
+    size_t numStates = 0;
+    size_t numTerminal = 0;
+    std::function<void(MNKState<3, 3>&)> visit = [&](MNKState<3, 3>& state) {
+        numStates++;
+        const auto actions = problem.getAvailableActions(state);
+        if (problem.isTerminal(state))
+        {
+            numTerminal++;
+            EXPECT_TRUE(actions.empty());
+            return;
+        }
+        for (const auto action : actions)
+        {
+            const auto before = state;
+            problem.performAction(action, state);
+            visit(state);
+            problem.undoAction(action, state);
+            EXPECT_TRUE(state == before);
+            EXPECT_EQ(state.numRemainingActions, before.numRemainingActions);
+        }
+    };
+    MNKState<3, 3> state{};
+    visit(state);
+    EXPECT_EQ(numStates, 549946);
+    EXPECT_EQ(numTerminal, 255168);
+}
+
+TEST(MNKProblem, GomokuLines)
+{
+    const Gomoku problem{};
+    using State = Gomoku::StateType;
+
+    // the second player plays far away on every second cell of the last row, so its stones never form a line. Returns
+    // the state and the rewards of the last stone of the first player
+    const auto lineWith = [&problem](std::array<size_t, 2> start, int dx, int dy, size_t length) {
+        State state{};
+        Gomoku::ValueVector rewards{};
+        for (size_t i = 0; i < length; ++i)
+        {
+            const size_t x = start[0] + size_t(int(i) * dx);
+            const size_t y = start[1] + size_t(int(i) * dy);
+            rewards = play(problem, state, {{x, y}});
+            if (i + 1 < length) { play(problem, state, {{2 * i, 14}}); }
+        }
+        return std::pair{state, rewards};
+    };
+
+    for (const auto& [start, dx, dy] : {std::tuple{std::array<size_t, 2>{10, 0}, 1, 0},
+                                        std::tuple{std::array<size_t, 2>{0, 10}, 0, -1},
+                                        std::tuple{std::array<size_t, 2>{3, 3}, 1, 1},
+                                        std::tuple{std::array<size_t, 2>{4, 4}, -1, 1}})
+    {
+        const auto [four, fourRewards] = lineWith(start, dx, dy, 4);
+        EXPECT_FALSE(problem.isTerminal(four));
+        EXPECT_EQ(fourRewards[0], 0);
+
+        const auto [five, fiveRewards] = lineWith(start, dx, dy, 5);
+        EXPECT_TRUE(problem.isTerminal(five));
+        EXPECT_TRUE(problem.getAvailableActions(five).empty());
+        EXPECT_EQ(fiveRewards[0], WIN);
+        EXPECT_EQ(fiveRewards[1], 0);
+    }
+
+    // stones at the end of one row and the start of the next one are no line
+    State state{};
+    play(problem, state, {{12, 0}, {0, 14}, {13, 0}, {1, 14}, {14, 0}, {2, 14}, {0, 1}, {4, 14}, {1, 1}});
+    EXPECT_FALSE(problem.isTerminal(state));
+    EXPECT_EQ(problem.getAvailableActions(state).size(), Gomoku::NUM_CELLS - 9);
+}
+
+TEST(MNKProblem, SolverFindsWin)
+{
+    using Solver = mcts::Solver<MNKProblem<7, 7, 4>, mcts::UCB1SelectionPolicy<float>,
+                                mcts::RolloutPolicy<MNKRandomPolicy<7, 7, 4>>>;
+    const MNKProblem<7, 7, 4> problem{};
+    MNKState<7, 7> state{};
+    // the first player has three in the middle row, blocked on the left side, and completes four on the right side
+    play(problem, state, {{2, 3}, {0, 0}, {3, 3}, {6, 6}, {4, 3}, {1, 3}});
+
+    Solver solver{};
+    solver.parameter().numIterations = 500;  // NOLINT
+    solver.seed(1);
+    const auto action = solver.run(problem, state);
+    EXPECT_EQ(action, (Move<7>{3 * 7 + 5}));
+}
@@ -0,0 +1,85 @@
+#include "mcts/rollout/rollout.h"
+#include "mcts/selection/ucb1.h"
+#include "mcts/solver.h"
+#include "perfect_play.h"
+#include "tic_tac_toe.h"
+#include "zbo/stop_watch.h"
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <vector>
+
+using namespace mcts;
+using namespace ttt;
+
+using TicTacToeSolver = mcts::Solver<TicTacToeProblem, UCB1SelectionPolicy<float>, RolloutPolicy<TicTacToePolicy>>;
+
+constexpr std::array<size_t, 7> ITERATIONS = {10, 20, 50, 100, 200, 500, 1000};
+constexpr size_t NUM_REPETITIONS = 20;
+
+/// One position per class of symmetric positions in which not every move is optimal
+std::vector<TicTacToeState> generatePositions(const TicTacToeProblem& problem)
+{
+    std::vector<TicTacToeState> positions;
+    std::set<uint32_t> visited;
+    std::function<void(TicTacToeState&)> visit = [&](TicTacToeState& state) {
+        if (problem.isTerminal(state) || !visited.insert(state.canonicalKey()).second) { return; }
+
+        bool decisive = false;
+        for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+        {
+            decisive = decisive || !PerfectPlay::isOptimal(state, static_cast<Actions>(__builtin_ctz(empty)));
+        }
+        if (decisive) { positions.push_back(state); }
+
+        for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+        {
+            const auto action = static_cast<Actions>(__builtin_ctz(empty));
+            problem.performAction(action, state);
+            visit(state);
+            problem.undoAction(action, state);
+        }
+    };
+    TicTacToeState state{};
+    visit(state);
+    return positions;
+}
+
+int main(int, char**)
+{
+    const TicTacToeProblem problem{};
+    const auto positions = generatePositions(problem);
+    std::cout << "#### Fraction of optimal moves per iteration on " << positions.size()
+              << " positions in which not every move is optimal: " << std::endl;
+
+    for (const size_t iterations : ITERATIONS)
+    {
+        TicTacToeSolver solver{};
+        solver.parameter().numIterations = iterations;
+        solver.seed(iterations);
+
+        size_t numOptimal = 0;
+        size_t numMoves = 0;
+        zbo::StopWatch watch;
+        watch.start();
+        for (const auto& position : positions)
+        {
+            for (size_t rep = 0; rep < NUM_REPETITIONS; ++rep)
+            {
+                numOptimal += PerfectPlay::isOptimal(position, solver.run(problem, position)) ? 1 : 0;
+                numMoves++;
+            }
+        }
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(watch.stop());
+
+        constexpr int PERCENT = 100;
+        std::cout << std::setw(6) << iterations << " iterations: optimal moves " << std::setw(6) << std::fixed
+                  << std::setprecision(1) << double(numOptimal) / double(numMoves) * PERCENT << "%, " << std::setw(8)
+                  << double(duration.count()) / double(numMoves) << "us/move\n";
+    }
+    return 0;
+}
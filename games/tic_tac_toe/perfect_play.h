@@ -0,0 +1,200 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tic_tac_toe.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ttt {
+
+/// number of boards when every cell is either empty or occupied by one of the players (3^9)
+constexpr size_t NUM_BOARDS = 19683;
+
+namespace detail {
+/// for every mask of cells, the sum of 3^cell over its cells
+constexpr std::array<uint16_t, NUM_MASKS> createBase3Table()
+{
+    std::array<uint16_t, NUM_MASKS> table{};
+    for (size_t mask = 0; mask < NUM_MASKS; ++mask)
+    {
+        uint16_t power = 1;
+        for (size_t cell = 0; cell < BOARD_SIZE; ++cell, power *= 3)
+        {
+            if (((mask >> cell) & 1U) != 0) { table[mask] += power; }
+        }
+    }
+    return table;
+}
+}  // namespace detail
+
+constexpr std::array<uint16_t, NUM_MASKS> BASE3_TABLE = detail::createBase3Table();
+
+/// index of the board in base 3 (0 empty, 1 player 1, 2 player 2 per cell), which is collision free for all boards
+constexpr size_t boardIndex(const std::array<uint16_t, 2>& board)
+{
+    return BASE3_TABLE[board[0]] + 2U * BASE3_TABLE[board[1]];
+}
+
+/// game theoretic value of a position
+enum class Outcome : int8_t
+{
+    LOSS = -1,
+    DRAW = 0,
+    WIN = 1
+};
+
+/**
+ * @brief Game theoretic values of all tic-tac-toe positions, to be used as oracle for the move quality of the solver.
+ * All positions reachable from the empty board are enumerated once and solved by retrograde analysis: from the full
+ * boards back to the empty one, every position gets the best value of its successors for the player to move.
+ * The values are stored per board index (19683 bytes), the player to move is given by the number of stones.
+ */
+class PerfectPlay
+{
+  public:
+    /// game theoretic value of the position for the player to move, terminal positions are lost or drawn
+    [[nodiscard]] static Outcome value(const TicTacToeState& state) { return valueOf(boardIndex(state.board)); }
+
+    /// value for the player to move when playing the action and playing perfectly afterwards
+    [[nodiscard]] static Outcome actionValue(const TicTacToeState& state, Actions action)
+    {
+        assert(state.field(actionToBoardIdx(action)) == FieldType::EMPTY);
+        auto board = state.board;
+        board[state.getCurrentPlayer()] |= actionToMask(action);
+        return static_cast<Outcome>(-static_cast<int8_t>(valueOf(boardIndex(board))));
+    }
+
+    /// whether the action keeps the game theoretic value of the position
+    [[nodiscard]] static bool isOptimal(const TicTacToeState& state, Actions action)
+    {
+        return actionValue(state, action) == value(state);
+    }
+
+    /// number of positions that can be reached from the empty board, including the terminal ones
+    [[nodiscard]] static size_t numPositions() { return solved().numPositions; }
+
+  private:
+    static constexpr int8_t UNREACHABLE = std::numeric_limits<int8_t>::min();
+
+    struct Solution
+    {
+        std::array<int8_t, NUM_BOARDS> values{};
+        size_t numPositions{0};
+    };
+
+    [[nodiscard]] static Outcome valueOf(size_t index)
+    {
+        const int8_t value = solved().values[index];
+        assert(value != UNREACHABLE && "Position can not be reached from the empty board");
+        return static_cast<Outcome>(value);
+    }
+
+    [[nodiscard]] static const Solution& solved()
+    {
+        static const Solution solution = solve();
+        return solution;
+    }
+
+    static Solution solve()
+    {
+        Solution solution{};
+        solution.values.fill(UNREACHABLE);
+
+        // all reachable positions, grouped by the number of stones on the board
+        std::array<std::vector<TicTacToeState>, BOARD_SIZE + 1> layers{};
+        std::array<bool, NUM_BOARDS> reached{};
+        layers[0].emplace_back();
+        reached[0] = true;
+        const TicTacToeProblem problem{};
+        for (size_t stones = 0; stones < BOARD_SIZE; ++stones)
+        {
+            for (TicTacToeState state : layers[stones])
+            {
+                if (problem.isTerminal(state)) { continue; }
+                for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+                {
+                    const auto action = static_cast<Actions>(__builtin_ctz(empty));
+                    problem.performAction(action, state);
+                    const size_t index = boardIndex(state.board);
+                    if (!reached[index])
+                    {
+                        reached[index] = true;
+                        layers[stones + 1].push_back(state);
+                    }
+                    problem.undoAction(action, state);
+                }
+            }
+        }
+
+        // retrograde analysis, successors always have one stone more
+        for (size_t stones = BOARD_SIZE + 1; stones-- > 0;)
+        {
+            for (const TicTacToeState& state : layers[stones])
+            {
+                solution.values[boardIndex(state.board)] = static_cast<int8_t>(solveFromSuccessors(state, solution));
+            }
+            solution.numPositions += layers[stones].size();
+        }
+        return solution;
+    }
+
+    static Outcome solveFromSuccessors(const TicTacToeState& state, const Solution& solution)
+    {
+        // the player that moved last completed a row
+        if (isWin(state.board[1 - state.getCurrentPlayer()])) { return Outcome::LOSS; }
+        if (state.empty() == 0) { return Outcome::DRAW; }
+
+        int8_t best = static_cast<int8_t>(Outcome::LOSS);
+        for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+        {
+            auto board = state.board;
+            board[state.getCurrentPlayer()] |= uint16_t(1U << __builtin_ctz(empty));
+            best = std::max(best, static_cast<int8_t>(-solution.values[boardIndex(board)]));
+        }
+        return static_cast<Outcome>(best);
+    }
+};
+
+/// Plays the first optimal move of a position, can be used as opponent or rollout policy
+class PerfectPlayPolicy
+{
+  public:
+    Actions getAction(const TicTacToeState& state, const TicTacToeProblem&) const
+    {
+        assert(state.numRemainingActions > 0);
+        for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+        {
+            const auto action = static_cast<Actions>(__builtin_ctz(empty));
+            if (PerfectPlay::isOptimal(state, action)) { return action; }
+        }
+        assert(false && "A position always has an optimal move");
+        return static_cast<Actions>(__builtin_ctz(state.empty()));
+    }
+};
+}  // namespace ttt
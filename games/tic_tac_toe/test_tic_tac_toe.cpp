@@ -0,0 +1,291 @@
+#include "mcts/rollout/rollout.h"
+#include "mcts/solver.h"
+#include "perfect_play.h"
+#include "tic_tac_toe.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <set>
+
+using namespace ttt;
+
+namespace {
+constexpr std::array<std::array<size_t, 3>, 8> WIN_PATTERNS{{
+    {0, 1, 2},  // row 1
+    {3, 4, 5},  // row 2
+    {6, 7, 8},  // row 3
+    {0, 3, 6},  // col 1
+    {1, 4, 7},  // col 2
+    {2, 5, 8},  // col 3
+    {0, 4, 8},  // diag 1
+    {2, 4, 6}   // diag 2
+}};
+
+/// cell by cell win check
+bool referenceDidPlayerWin(const TicTacToeState& state, uint8_t player)
+{
+    const auto field = static_cast<FieldType>(player + 1);
+    return std::any_of(WIN_PATTERNS.begin(), WIN_PATTERNS.end(), [&state, field](const auto& pattern) {
+        return std::all_of(pattern.begin(), pattern.end(), [&state, field](size_t idx) {
+            return state.field(idx) == field;
+        });
+    });
+}
+
+/// cell by cell search for an empty cell that completes a row, column or diagonal of any player
+std::optional<Actions> referenceThreat(const TicTacToeState& state)
+{
+    for (size_t i = 0; i < BOARD_SIZE; ++i)
+    {
+        if (state.field(i) != FieldType::EMPTY) { continue; }
+        for (const auto& pattern : WIN_PATTERNS)
+        {
+            if (std::find(pattern.begin(), pattern.end(), i) == pattern.end()) { continue; }
+            std::array<FieldType, 2> others{};
+            size_t numOthers = 0;
+            for (const size_t idx : pattern)
+            {
+                if (idx != i) { others.at(numOthers++) = state.field(idx); }
+            }
+            if (others[0] == others[1] && others[0] != FieldType::EMPTY) { return static_cast<Actions>(i); }
+        }
+    }
+    return std::nullopt;
+}
+
+/// calls the visitor for every state reachable from the empty board, without the symmetry reduction of the first moves
+void forAllStates(const std::function<void(const TicTacToeState&)>& visitor)
+{
+    const TicTacToeProblem problem{};
+    std::function<void(TicTacToeState&)> visit = [&](TicTacToeState& state) {
+        visitor(state);
+        if (problem.isTerminal(state)) { return; }
+        for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+        {
+            const auto action = static_cast<Actions>(__builtin_ctz(empty));
+            problem.performAction(action, state);
+            visit(state);
+            problem.undoAction(action, state);
+        }
+    };
+    TicTacToeState state{};
+    visit(state);
+}
+}  // namespace
+
+TEST(TicTacToe, WinTable)
+{
+    for (uint16_t mask = 0; mask < NUM_MASKS; ++mask)
+    {
+        TicTacToeState state{};
+        state.board[0] = mask;
+        EXPECT_EQ(isWin(mask), referenceDidPlayerWin(state, 0)) << mask;
+    }
+}
+
+TEST(TicTacToe, AllStatesMatchReference)
+{
+    const TicTacToeProblem problem{};
+    const TicTacToePolicy policy{};
+    size_t numStates = 0;
+    size_t numTerminal = 0;
+    forAllStates([&](const TicTacToeState& state) {
+        numStates++;
+        ASSERT_EQ(state.board[0] & state.board[1], 0);
+        for (const uint8_t player : {0, 1})
+        {
+            EXPECT_EQ(problem.didPlayerWin(state, player), referenceDidPlayerWin(state, player))
+                << state.board[0] << " " << state.board[1];
+        }
+
+        if (problem.isTerminal(state))
+        {
+            numTerminal++;
+            EXPECT_TRUE(problem.getAvailableActions(state).empty());
+            return;
+        }
+        EXPECT_EQ(state.numRemainingActions, __builtin_popcount(state.empty()));
+
+        // completing a row is deterministic, otherwise any empty cell can be played
+        const Actions action = policy.getAction(state, problem);
+        const auto threat = referenceThreat(state);
+        if (threat.has_value()) { EXPECT_EQ(action, *threat) << state.board[0] << " " << state.board[1]; }
+        EXPECT_EQ(state.field(actionToBoardIdx(action)), FieldType::EMPTY);
+
+        // the reduced actions reach every position of the unreduced ones up to symmetry, but none of them twice
+        TicTacToeState next = state;
+        std::set<uint32_t> reachable;
+        for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+        {
+            const auto cell = static_cast<Actions>(__builtin_ctz(empty));
+            problem.performAction(cell, next);
+            reachable.insert(next.canonicalKey());
+            problem.undoAction(cell, next);
+        }
+        std::set<uint32_t> reduced;
+        for (const auto available : problem.getAvailableActions(state))
+        {
+            problem.performAction(available, next);
+            EXPECT_TRUE(reduced.insert(next.canonicalKey()).second);
+            problem.undoAction(available, next);
+        }
+        EXPECT_EQ(reduced, reachable) << state.board[0] << " " << state.board[1];
+    });
+    // number of tic-tac-toe games positions without symmetry reduction, including the empty board
+    EXPECT_EQ(numStates, 549946);
+    EXPECT_EQ(numTerminal, 255168);
+}
+
+TEST(TicTacToe, AvailableActions)
+{
+    const TicTacToeProblem problem{};
+    TicTacToeState state{};
+    EXPECT_EQ(problem.getAvailableActions(state).size(), 3);
+    problem.performAction(Actions::MIDDLE, state);
+    EXPECT_EQ(problem.getAvailableActions(state).size(), 2);
+    problem.performAction(Actions::TOP_LEFT, state);
+
+    // the board is still symmetric to the main diagonal
+    const auto actions = problem.getAvailableActions(state);
+    ASSERT_EQ(actions.size(), 4);
+    for (const auto action : actions) { EXPECT_EQ(state.field(actionToBoardIdx(action)), FieldType::EMPTY); }
+    EXPECT_TRUE(std::is_sorted(actions.begin(), actions.end()));
+
+    problem.performAction(Actions::BOTTOM_MIDDLE, state);
+    EXPECT_EQ(problem.getAvailableActions(state).size(), 6);
+}
+
+TEST(TicTacToe, SymmetricStatesShareCanonicalKey)
+{
+    const TicTacToeProblem problem{};
+    TicTacToeState state{};
+    TicTacToeState mirrored{};
+    problem.performAction(Actions::TOP_LEFT, state);
+    problem.performAction(Actions::TOP_RIGHT, mirrored);
+    problem.performAction(Actions::MIDDLE_RIGHT, state);
+    problem.performAction(Actions::MIDDLE_LEFT, mirrored);
+
+    EXPECT_FALSE(state == mirrored);
+    EXPECT_EQ(state.canonicalKey(), mirrored.canonicalKey());
+    EXPECT_NE(std::hash<TicTacToeState>{}(state), std::hash<TicTacToeState>{}(mirrored));
+}
+
+TEST(TicTacToe, GameTreeSize)
+{
+    const TicTacToeProblem problem{};
+    size_t numNodes = 0;
+    std::function<void(TicTacToeState&)> visit = [&](TicTacToeState& state) {
+        numNodes++;
+        for (const auto action : problem.getAvailableActions(state))
+        {
+            problem.performAction(action, state);
+            visit(state);
+            problem.undoAction(action, state);
+        }
+    };
+    TicTacToeState state{};
+    visit(state);
+    // 92092 nodes with the symmetry reduction of only the first two moves
+    EXPECT_EQ(numNodes, 58524);
+}
+
+TEST(TicTacToe, UndoAction)
+{
+    TicTacToeProblem p{};
+    TicTacToeState state{};
+    p.performAction(Actions::MIDDLE, state);
+    const TicTacToeState start = state;
+
+    mcts::RolloutPolicy<TicTacToePolicy> rolloutPolicy{};
+    for (int i = 0; i < 20; i++)  // NOLINT
+    {
+        rolloutPolicy.rolloutInPlace(state, p);
+        EXPECT_EQ(state.board, start.board);
+        EXPECT_EQ(state.numRemainingActions, start.numRemainingActions);
+        EXPECT_EQ(state.getCurrentPlayer(), start.getCurrentPlayer());
+    }
+
+    // undoing a winning move has to restore the remaining actions that were cleared by the win
+    for (auto action : {Actions::TOP_LEFT, Actions::TOP_MIDDLE, Actions::BOTTOM_LEFT})
+    {
+        p.performAction(action, state);
+    }
+    p.performAction(Actions::BOTTOM_MIDDLE, state);
+    ASSERT_TRUE(p.isTerminal(state));
+    p.undoAction(Actions::BOTTOM_MIDDLE, state);
+    EXPECT_EQ(state.numRemainingActions, 5);
+    EXPECT_EQ(state.getCurrentPlayer(), 0);
+}
+
+TEST(PerfectPlay, Values)
+{
+    // number of legal tic-tac-toe positions, including the empty and the terminal ones
+    EXPECT_EQ(PerfectPlay::numPositions(), 5478);
+
+    const TicTacToeProblem problem{};
+    TicTacToeState state{};
+    EXPECT_EQ(PerfectPlay::value(state), Outcome::DRAW);
+    problem.performAction(Actions::MIDDLE, state);
+    EXPECT_EQ(PerfectPlay::value(state), Outcome::DRAW);
+
+    // answering the center with an edge loses, the corners hold the draw
+    EXPECT_EQ(PerfectPlay::actionValue(state, Actions::TOP_MIDDLE), Outcome::LOSS);
+    EXPECT_EQ(PerfectPlay::actionValue(state, Actions::TOP_LEFT), Outcome::DRAW);
+    EXPECT_FALSE(PerfectPlay::isOptimal(state, Actions::MIDDLE_RIGHT));
+    EXPECT_TRUE(PerfectPlay::isOptimal(state, Actions::BOTTOM_RIGHT));
+
+    problem.performAction(Actions::TOP_MIDDLE, state);
+    EXPECT_EQ(PerfectPlay::value(state), Outcome::WIN);
+}
+
+TEST(PerfectPlay, NeverLoses)
+{
+    // the perfect policy plays against every possible sequence of opponent moves
+    const TicTacToeProblem problem{};
+    const PerfectPlayPolicy policy{};
+    for (const uint8_t perfectPlayer : {0, 1})
+    {
+        std::function<void(TicTacToeState&)> visit = [&](TicTacToeState& state) {
+            if (problem.isTerminal(state))
+            {
+                EXPECT_FALSE(problem.didPlayerWin(state, 1 - perfectPlayer));
+                return;
+            }
+            if (state.getCurrentPlayer() == perfectPlayer)
+            {
+                const auto action = policy.getAction(state, problem);
+                EXPECT_TRUE(PerfectPlay::isOptimal(state, action));
+                problem.performAction(action, state);
+                visit(state);
+                problem.undoAction(action, state);
+                return;
+            }
+            for (uint32_t empty = state.empty(); empty != 0; empty &= empty - 1)
+            {
+                const auto action = static_cast<Actions>(__builtin_ctz(empty));
+                problem.performAction(action, state);
+                visit(state);
+                problem.undoAction(action, state);
+            }
+        };
+        TicTacToeState state{};
+        visit(state);
+    }
+}
+
+TEST(TicTacToe, Solver)
+{
+    // perfect play leads to a draw, which the solver has to find from the empty board
+    mcts::Solver<TicTacToeProblem, mcts::UCB1SelectionPolicy<float>, mcts::RolloutPolicy<TicTacToePolicy>> solver{};
+    solver.parameter().numIterations = 20000;  // NOLINT
+    solver.seed(1);
+    const TicTacToeProblem problem{};
+    TicTacToeState state{};
+    TicTacToeProblem::ValueVector rewards{};
+    while (!problem.isTerminal(state)) { rewards = problem.performAction(solver.run(problem, state), state); }
+    EXPECT_EQ(rewards[0], WIN / 2);
+    EXPECT_EQ(rewards[1], WIN / 2);
+}
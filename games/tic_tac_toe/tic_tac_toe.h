@@ -22,30 +22,82 @@
 
 #pragma once
 
+#include "mcts/grid_symmetry.h"
 #include "mcts/problem.h"
+#include "mcts/random.h"
 #include "mcts/state.h"
 #include "zbo/max_size_vector.h"
 #include "zbo/meta_enum.h"
 
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 namespace ttt {
 
 constexpr size_t BOARD_SIZE = 9;
-
-constexpr std::array<std::array<size_t, 3>, 8> WIN_PATTERNS{{
-    {0, 1, 2},  // row 1
-    {3, 4, 5},  // row 2
-    {6, 7, 8},  // row 3
-    {0, 3, 6},  // col 1
-    {1, 4, 7},  // col 2
-    {2, 5, 8},  // col 3
-    {0, 4, 8},  // diag 1
-    {2, 4, 6}   // diag 2
+constexpr uint16_t FULL_BOARD = (1U << BOARD_SIZE) - 1;
+constexpr size_t NUM_MASKS = 1U << BOARD_SIZE;
+
+/// cells (bit i is cell i) of the rows, columns and diagonals
+constexpr std::array<uint16_t, 8> WIN_MASKS{{
+    0b000000111,  // row 1
+    0b000111000,  // row 2
+    0b111000000,  // row 3
+    0b001001001,  // col 1
+    0b010010010,  // col 2
+    0b100100100,  // col 3
+    0b100010001,  // diag 1
+    0b001010100   // diag 2
 }};
 
+namespace detail {
+/// for every mask of cells of a player, the empty cells that would complete a row, column or diagonal. Bit 15 marks
+/// masks that already contain one
+constexpr std::array<uint16_t, NUM_MASKS> createWinTable()
+{
+    constexpr uint16_t WIN_FLAG = 1U << 15U;
+    std::array<uint16_t, NUM_MASKS> table{};
+    for (size_t mask = 0; mask < NUM_MASKS; ++mask)
+    {
+        for (const uint16_t pattern : WIN_MASKS)
+        {
+            const auto missing = static_cast<uint16_t>(pattern & ~mask);
+            if (missing == 0) { table[mask] |= WIN_FLAG; }
+            // exactly one cell of the pattern is missing
+            else if ((missing & (missing - 1)) == 0)
+            {
+                table[mask] |= missing;
+            }
+        }
+    }
+    return table;
+}
+}  // namespace detail
+
+constexpr std::array<uint16_t, NUM_MASKS> WIN_TABLE = detail::createWinTable();
+
+/// whether the cells of a player contain a row, column or diagonal
+constexpr bool isWin(uint16_t mask)
+{
+    return (WIN_TABLE[mask] >> 15U) != 0;
+}
+
+/// cells that would complete a row, column or diagonal for the cells of a player (can be occupied by the opponent)
+constexpr uint16_t winningCells(uint16_t mask)
+{
+    return WIN_TABLE[mask] & FULL_BOARD;
+}
+
+/// rotations and reflections of the board
+using BoardSymmetry = mcts::GridSymmetry<3, uint16_t>;
+
 ZBO_ENUM_CLASS(FieldType, uint8_t, EMPTY = 0, PLAYER1 = 1, PLAYER2 = 2)
 ZBO_ENUM_CLASS(Actions, uint8_t, TOP_LEFT = 0, TOP_MIDDLE = 1, TOP_RIGHT = 2, MIDDLE_LEFT = 3, MIDDLE = 4,
                MIDDLE_RIGHT = 5, BOTTOM_LEFT = 6, BOTTOM_MIDDLE = 7, BOTTOM_RIGHT = 8)
@@ -61,6 +113,16 @@ inline std::ostream& operator<<(std::ostream& stream, Actions action)
 }
 
 constexpr float WIN = 1.0f;
+constexpr size_t actionToBoardIdx(Actions action)
+{
+    return static_cast<size_t>(action);
+}
+
+constexpr uint16_t actionToMask(Actions action)
+{
+    return static_cast<uint16_t>(1U << actionToBoardIdx(action));
+}
+
 class TicTacToeState : public mcts::State<TicTacToeState>
 {
   public:
@@ -68,28 +130,52 @@ class TicTacToeState : public mcts::State<TicTacToeState>
     void resetBoard()
     {
         numRemainingActions = BOARD_SIZE;
-        board.fill(FieldType::EMPTY);
+        board.fill(0);
     }
 
     std::ostream& writeToStream(std::ostream& stream) const
     {
         for (uint8_t i = 0; i < BOARD_SIZE; ++i)
         {
-            stream << int(board.at(i)) << " ";
+            stream << int(field(i)) << " ";
             if (i % 3 == 2) { stream << "\n"; }
         }
         return mcts::State<TicTacToeState>::writeToStream(stream);
     }
 
-    std::array<FieldType, BOARD_SIZE> board{};
+    [[nodiscard]] FieldType field(size_t idx) const
+    {
+        if (((board[0] >> idx) & 1U) != 0) { return FieldType::PLAYER1; }
+        if (((board[1] >> idx) & 1U) != 0) { return FieldType::PLAYER2; }
+        return FieldType::EMPTY;
+    }
+
+    [[nodiscard]] uint16_t occupied() const { return board[0] | board[1]; }
+    [[nodiscard]] uint16_t empty() const { return FULL_BOARD & ~occupied(); }
+
+    /// sets numRemainingActions from the empty cells, or to 0 if the last move won
+    void updateRemainingActions(bool won)
+    {
+        numRemainingActions = won ? 0 : static_cast<uint8_t>(__builtin_popcount(empty()));
+    }
+
+    /// boards of both players in one key, which is the same for all rotations and reflections of the position
+    [[nodiscard]] uint32_t canonicalKey() const
+    {
+        const auto canonical = BoardSymmetry::canonical(board);
+        return uint32_t(canonical[0]) | (uint32_t(canonical[1]) << BOARD_SIZE);
+    }
+
+    [[nodiscard]] bool operator==(const TicTacToeState& rhs) const
+    {
+        return board == rhs.board && getCurrentPlayer() == rhs.getCurrentPlayer();
+    }
+
+    /// cells (bit i is cell i) of each player
+    std::array<uint16_t, 2> board{};
     uint8_t numRemainingActions{BOARD_SIZE};
 };
 
-constexpr size_t actionToBoardIdx(Actions action)
-{
-    return static_cast<size_t>(action);
-}
-
 struct ProblemDefinition
 {
     using ValueType = float;
@@ -115,7 +201,8 @@ class TicTacToeProblem : public mcts::Problem<TicTacToeProblem, ProblemDefinitio
     }
 
     /**
-     * Should return a list of all possible actions for this player
+     * Should return a list of all possible actions for this player. Of moves that lead to symmetric positions (i.e.
+     * that are mapped onto each other by a rotation or reflection that keeps the board unchanged), only one is returned
      */
     [[nodiscard]] zbo::MaxSizeVector<Actions, BOARD_SIZE> getAvailableActions(const TicTacToeState& state) const
     {
@@ -125,60 +212,30 @@ class TicTacToeProblem : public mcts::Problem<TicTacToeProblem, ProblemDefinitio
         {
             return {};
         }
-        else if (state.numRemainingActions ==
-                 BOARD_SIZE)  // for the first move, we can apply symmetric reduction of the state space
-        {
-            return ActionVec{Actions::TOP_LEFT, Actions::TOP_MIDDLE, Actions::MIDDLE};
-        }
-        else if (state.numRemainingActions == BOARD_SIZE - 1 &&
-                 (state.board[actionToBoardIdx(Actions::TOP_LEFT)] != FieldType::EMPTY ||
-                  state.board[actionToBoardIdx(Actions::TOP_MIDDLE)] != FieldType::EMPTY ||
-                  state.board[actionToBoardIdx(Actions::MIDDLE)] !=
-                      FieldType::EMPTY))  // second move, we can apply symmetric reduction of the state space
-        {
-            if (state.board[actionToBoardIdx(Actions::MIDDLE)] != FieldType::EMPTY)  // first move was middle
-            {
-                return ActionVec{Actions::TOP_LEFT, Actions::TOP_MIDDLE};
-            }
-            else if (state.board[actionToBoardIdx(Actions::TOP_LEFT)] !=
-                     FieldType::EMPTY)  // first move was left top corner
-            {
-                return ActionVec{Actions::TOP_MIDDLE, Actions::TOP_RIGHT, Actions::MIDDLE, Actions::MIDDLE_RIGHT,
-                                 Actions::BOTTOM_RIGHT};
-            }
-            else if (state.board[1] != FieldType::EMPTY)  // first move was top
-            {
-                return ActionVec{Actions::TOP_LEFT, Actions::MIDDLE_LEFT, Actions::BOTTOM_LEFT, Actions::MIDDLE,
-                                 Actions::BOTTOM_MIDDLE};
-            }
-        }
 
-        ActionVec remaining{};
-        for (uint8_t i = 0; i < BOARD_SIZE; ++i)
+        const auto symmetries = BoardSymmetry::stabilizer({state.board[0], state.board[1]});
+        ActionVec actions{};
+        for (uint32_t cells = BoardSymmetry::representatives(state.empty(), symmetries); cells != 0; cells &= cells - 1)
         {
-            if (state.board.at(i) == FieldType::EMPTY) { remaining.push_back(static_cast<Actions>(i)); }
+            actions.push_back(static_cast<Actions>(__builtin_ctz(cells)));
         }
-        return remaining;
+        return actions;
     };
-
     /**
      * Apply the action to the gamestate. Gamestate will be changed with this
      */
     ValueVector performAction(const Actions action, TicTacToeState& state) const
     {
-        assert(state.board.at(actionToBoardIdx(action)) == FieldType::EMPTY &&
-               "Action is not possible, because already played");
+        assert((state.occupied() & actionToMask(action)) == 0 && "Action is not possible, because already played");
         ValueVector retval{};
 
-        state.board.at(actionToBoardIdx(action)) = static_cast<FieldType>(state.getCurrentPlayer() + 1);
-        state.numRemainingActions--;
+        state.board[state.getCurrentPlayer()] |= actionToMask(action);
+        const bool won = didPlayerWin(state, state.getCurrentPlayer());
+        state.updateRemainingActions(won);
 
-        assert(state.numRemainingActions <= 9);
-
-        if (didPlayerWin(state, state.getCurrentPlayer()))
+        if (won)
         {
             retval[state.getCurrentPlayer()] = WIN;
-            state.numRemainingActions = 0;
         }
         else if (state.numRemainingActions == 0)
         {
@@ -189,6 +246,20 @@ class TicTacToeProblem : public mcts::Problem<TicTacToeProblem, ProblemDefinitio
         return retval;
     }
 
+    /**
+     * Revert the action performed last on this gamestate
+     */
+    void undoAction(const Actions action, TicTacToeState& state) const
+    {
+        const uint16_t mask = actionToMask(action);
+        assert((state.occupied() & mask) != 0 && "Action was not played");
+
+        const uint8_t player = (state.board[0] & mask) != 0 ? 0 : 1;
+        state.setCurrentPlayer(player);
+        state.board[player] &= ~mask;
+        state.updateRemainingActions(false);
+    }
+
     /**
      * Determines whether the game is over. That can be if no actions are possible or if another desired or undesired
      * state is acchieved
@@ -197,75 +268,49 @@ class TicTacToeProblem : public mcts::Problem<TicTacToeProblem, ProblemDefinitio
 
     [[nodiscard]] bool didPlayerWin(const TicTacToeState& state, uint8_t player) const
     {
-        if (state.numRemainingActions > 4) { return false; }
-
-        const auto pp1 = static_cast<FieldType>(player + 1);
-
-        return std::any_of(WIN_PATTERNS.begin(), WIN_PATTERNS.end(),
-                           [&state, pp1](const std::array<size_t, 3>& pattern) {
-                               return std::all_of(pattern.begin(), pattern.end(),
-                                                  [&state, pp1](size_t idx) { return state.board.at(idx) == pp1; });
-                           });
+        return isWin(state.board[player]);
     }
 };
 
 class TicTacToePolicy
 {
   public:
-    static Actions getAction(const TicTacToeState& state, const TicTacToeProblem&)
+    Actions getAction(const TicTacToeState& state, const TicTacToeProblem&) const
     {
         assert(state.numRemainingActions > 0);
+        const uint32_t empty = state.empty();
 
         // check whether we have to stop a instant win, or if we can win instantly
-        for (uint8_t i = 0; i < BOARD_SIZE; ++i)
-        {
-            uint8_t row = i / 3;
-            uint8_t column = i % 3;
-            auto action = static_cast<Actions>(i);
-            if (state.board.at(i) == FieldType::EMPTY)
-            {
-                // check rows:
-                if (state.board.at(row * 3 + (column + 1) % 3) == state.board.at(row * 3 + (column + 2) % 3) &&
-                    state.board.at(row * 3 + (column + 2) % 3) != FieldType::EMPTY)
-                {
-                    return action;
-                }
-                else if (state.board.at(((row + 1) % 3) * 3 + column) == state.board.at(((row + 2) % 3) * 3 + column) &&
-                         state.board.at(((row + 1) % 3) * 3 + column) != FieldType::EMPTY)
-                {
-                    return action;
-                }
-                else if (row == column &&
-                         state.board.at(((row + 1) % 3) * 3 + (column + 1) % 3) ==
-                             state.board.at(((row + 2) % 3) * 3 + (column + 2) % 3) &&
-                         state.board.at(((row + 2) % 3) * 3 + (column + 2) % 3) != FieldType::EMPTY)
-                {
-                    return action;
-                }
-                else if (row == 2 - column &&
-                         state.board.at(((row + 1) % 3) * 3 + (column + 3 - 1) % 3) ==
-                             state.board.at(((row + 2) % 3) * 3 + (column + 3 - 2) % 3) &&
-                         state.board.at(((row + 2) % 3) * 3 + (column + 3 - 2) % 3) != FieldType::EMPTY)
-                {
-                    return action;
-                }
-            }
-        }
+        const uint32_t threats = (winningCells(state.board[0]) | winningCells(state.board[1])) & empty;
+        if (threats != 0) { return static_cast<Actions>(__builtin_ctz(threats)); }
+
+        // otherwise a random empty cell
+        const auto actidx = static_cast<uint32_t>(engine_() % uint32_t(__builtin_popcount(empty)));
+#ifdef __BMI2__
+        return static_cast<Actions>(__builtin_ctz(_pdep_u32(1U << actidx, empty)));
+#else
+        uint32_t remaining = empty;
+        for (uint32_t i = 0; i < actidx; ++i) { remaining &= remaining - 1; }
+        return static_cast<Actions>(__builtin_ctz(remaining));
+#endif
+    }
 
-        uint8_t actidx = rand() % state.numRemainingActions;
-        for (uint8_t i = 0; i < BOARD_SIZE; ++i)
-        {
-            if (state.board.at(i) == FieldType::EMPTY)
-            {
-                if (actidx == 0) { return static_cast<Actions>(i); }
-                else
-                {
-                    actidx--;
-                }
-            }
-        }
-        assert(false);
-        return {};
+    void seed(size_t seed) { engine_.seed(seed); }
+
+  private:
+    mcts::ThreadLocalEngine engine_{};
+};
+}  // namespace ttt
+
+/// Hashes the exact position like operator== compares it. Tables that should merge symmetric positions are keyed on
+/// canonicalKey() instead
+namespace std {
+template <>
+struct hash<ttt::TicTacToeState>
+{
+    size_t operator()(const ttt::TicTacToeState& state) const noexcept
+    {
+        return mcts::splitMix64(uint32_t(state.board[0]) | (uint32_t(state.board[1]) << ttt::BOARD_SIZE));
     }
 };
-}  // namespace ttt
\ No newline at end of file
+}  // namespace std
\ No newline at end of file
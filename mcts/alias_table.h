@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+namespace mcts {
+
+/**
+ * @brief Walker's alias table (in the construction of Vose 1991) to sample from a discrete distribution of up to
+ * MAX_EVENTS events in constant time.
+ * Every event owns a column of equal width, split into the part of the event itself (threshold) and the part of one
+ * alias event. Sampling picks a column and compares the remaining random bits against its threshold. Thresholds are
+ * stored in 16 bit, which is precise enough for the probabilities of chance events.
+ */
+template <size_t MAX_EVENTS>
+class AliasTable
+{
+  public:
+    static_assert(MAX_EVENTS <= std::numeric_limits<uint8_t>::max() + 1, "Aliases are stored in 8 bits");
+
+    /// builds the table from the probabilities of the events, which are normalized by their sum
+    template <typename Probabilities, typename Projection>
+    void build(const Probabilities& events, Projection probability)
+    {
+        size_ = static_cast<uint16_t>(events.size());
+        if (events.size() == 0) { return; }
+
+        float sum = 0;
+        for (const auto& event : events) { sum += probability(event); }
+
+        // probabilities scaled to the column width, split into columns that are too small and too large
+        std::array<float, MAX_EVENTS> scaled{};
+        std::array<uint8_t, MAX_EVENTS> small{};
+        std::array<uint8_t, MAX_EVENTS> large{};
+        size_t numSmall = 0;
+        size_t numLarge = 0;
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            scaled[i] = probability(events[i]) * float(events.size()) / sum;
+            (scaled[i] < 1 ? small[numSmall++] : large[numLarge++]) = static_cast<uint8_t>(i);
+        }
+
+        // fill every small column with the rest of a large one
+        while (numSmall > 0 && numLarge > 0)
+        {
+            const uint8_t less = small[--numSmall];
+            const uint8_t more = large[numLarge - 1];
+            threshold_[less] = toThreshold(scaled[less]);
+            alias_[less] = more;
+            scaled[more] -= 1 - scaled[less];
+            if (scaled[more] < 1)
+            {
+                numLarge--;
+                small[numSmall++] = more;
+            }
+        }
+        // the remaining columns are full, up to rounding errors
+        for (size_t i = 0; i < numLarge; ++i) { setFull(large[i]); }
+        for (size_t i = 0; i < numSmall; ++i) { setFull(small[i]); }
+    }
+
+    /// index of the sampled event for a uniformly distributed 32 bit random number
+    [[nodiscard]] size_t sample(uint32_t random) const
+    {
+        assert(size_ > 0);
+        // the upper bits select the column, the lower ones decide between the column and its alias
+        const uint64_t scaled = uint64_t(random) * size_;
+        const auto column = size_t(scaled >> 32U);
+        const auto fraction = uint16_t(scaled >> 16U);
+        return fraction < threshold_[column] ? column : alias_[column];
+    }
+
+    [[nodiscard]] size_t size() const { return size_; }
+
+  private:
+    static constexpr float THRESHOLD_SCALE = 1U << 16U;
+
+    static uint16_t toThreshold(float fraction)
+    {
+        return static_cast<uint16_t>(std::min(fraction * THRESHOLD_SCALE, THRESHOLD_SCALE - 1));
+    }
+
+    void setFull(uint8_t column)
+    {
+        threshold_[column] = std::numeric_limits<uint16_t>::max();
+        alias_[column] = column;
+    }
+
+    std::array<uint16_t, MAX_EVENTS> threshold_{};
+    std::array<uint8_t, MAX_EVENTS> alias_{};
+    uint16_t size_{0};
+};
+
+}  // namespace mcts
@@ -23,6 +23,10 @@
 #pragma once
 #include "zbo/max_size_vector.h"
 
+#include <functional>
+#include <type_traits>
+#include <utility>
+
 namespace mcts::detail {
 template <int numChance, class ProblemType, class ProblemDefinition>
 class NeedsChanceEvents
@@ -65,4 +69,52 @@ class NeedActionFunction
         const typename ProblemDefinition::ActionType action, typename ProblemDefinition::StateType& state) const;
 };
 
+/// Detects the optional undo interface of a problem:
+///   void undoAction(ActionType action, StateType& state) const;
+///   void undoChanceEvent(ChanceEventType event, StateType& state) const;  // only needed with chance events
+/// An undo call has to restore the state exactly as it was before the corresponding perform call. If available, the
+/// solver and the rollout modify a single working state and unwind it instead of copying the state.
+template <class ProblemType, class = void>
+struct HasUndoAction : std::false_type
+{
+};
+
+template <class ProblemType>
+struct HasUndoAction<ProblemType, std::void_t<decltype(std::declval<const ProblemType&>().undoAction(
+                                      std::declval<typename ProblemType::ActionType>(),
+                                      std::declval<typename ProblemType::StateType&>()))>> : std::true_type
+{
+};
+
+template <class ProblemType, class = void>
+struct HasUndoChanceEvent : std::false_type
+{
+};
+
+template <class ProblemType>
+struct HasUndoChanceEvent<ProblemType, std::void_t<decltype(std::declval<const ProblemType&>().undoChanceEvent(
+                                           std::declval<typename ProblemType::ChanceEventType>(),
+                                           std::declval<typename ProblemType::StateType&>()))>> : std::true_type
+{
+};
+
+template <class ProblemType>
+constexpr bool SUPPORTS_UNDO =  // NOLINT(readability-identifier-naming)
+    HasUndoAction<ProblemType>::value && (!ProblemType::HAS_CHANCE_EVENTS || HasUndoChanceEvent<ProblemType>::value);
+
+/// Detects states that can be used as key of an unordered map, i.e. that specialize std::hash
+template <class StateType, class = void>
+struct HasStateHash : std::false_type
+{
+};
+
+template <class StateType>
+struct HasStateHash<StateType, std::void_t<decltype(std::hash<StateType>{}(std::declval<const StateType&>()))>>
+    : std::true_type
+{
+};
+
+template <class StateType>
+constexpr bool IS_HASHABLE = HasStateHash<StateType>::value;  // NOLINT(readability-identifier-naming)
+
 }  // namespace mcts::detail
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include <cassert>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 
 namespace mcts {
 
@@ -36,13 +37,7 @@ Solver<ProblemType, SelectionPolicy, RolloutPolicy>::run(const ProblemType& prob
 {
     running_ = true;
     init(problem, root);
-
-    while (currentIteration_ < params_.numIterations)
-    {
-        currentIteration_++;
-        iteration();
-    }
-
+    runIterations();
     running_ = false;
 
     return currentBestAction();
@@ -53,17 +48,87 @@ typename Solver<ProblemType, SelectionPolicy, RolloutPolicy>::ActionType
 Solver<ProblemType, SelectionPolicy, RolloutPolicy>::runFromExistingTree(NodeId newRoot)
 {
     running_ = true;
-    tree_ = tree_.subTree(newRoot);
+    // room for the kept nodes and the same worst case of new nodes as in init()
+    tree_ = tree_.subTree(newRoot, params_.numIterations * MAX_CHILDREN);
+    indexAfterstates();
     currentIteration_ = 0;
+    runIterations();
+    running_ = false;
 
+    return currentBestAction();
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::runIterations()
+{
+    rootSchedule_.reset(params_.numIterations);
     while (currentIteration_ < params_.numIterations)
     {
         currentIteration_++;
         iteration();
+        if (canStopEarly()) { break; }
     }
+}
 
-    running_ = false;
-    return currentBestAction();
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+bool Solver<ProblemType, SelectionPolicy, RolloutPolicy>::canStopEarly() const
+{
+    if (!params_.stopWhenBestIsUnreachable && params_.confidenceBoundWidth <= 0) { return false; }
+
+    const auto& rootNode = tree_.root();
+    if (rootNode.isLeaf()) { return false; }
+
+    const auto& decisionNode = std::get<DecisionNode>(rootNode.payload);
+    const auto& actionMap = decisionNode.statistics.getStatistics();
+
+    // nothing to decide if there is only one action at all
+    if (decisionNode.actions.size() == 1) { return true; }
+
+    if (params_.stopWhenBestIsUnreachable && params_.finalSelection == FinalSelection::MAX_VISITS &&
+        params_.rootStrategy == RootStrategy::SELECTION_POLICY)
+    {
+        uint32_t mostVisits = 0;
+        uint32_t secondMostVisits = 0;
+        for (const auto& stat : actionMap)
+        {
+            if (stat.count() > mostVisits)
+            {
+                secondMostVisits = mostVisits;
+                mostVisits = stat.count();
+            }
+            else
+            {
+                secondMostVisits = std::max(secondMostVisits, stat.count());
+            }
+        }
+
+        // expanding a decision node backpropagates one rollout per action, all through the same root action
+        constexpr size_t MAX_VISITS_PER_ITERATION = ProblemType::MAX_NUM_ACTIONS;
+        const size_t remainingVisits = (params_.numIterations - currentIteration_) * MAX_VISITS_PER_ITERATION;
+        if (secondMostVisits + remainingVisits < mostVisits) { return true; }
+    }
+
+    if (params_.confidenceBoundWidth > 0)
+    {
+        ValueType maxValue{};
+        ValueType minValue{};
+        decisionNode.statistics.getMinMaxValue(maxValue, minValue);
+        const auto bound = [this, range = maxValue - minValue](const StatisticType& stat) {
+            return params_.confidenceBoundWidth * range / std::sqrt(float(stat.count()));
+        };
+
+        const size_t best = bestActionIndex();
+        const auto& bestStat = actionMap.at(best);
+        const auto bestLowerBound = bestStat.value() - bound(bestStat);
+        for (size_t ac = 0; ac < decisionNode.actions.size(); ac++)
+        {
+            if (ac == best) { continue; }
+            const auto& stat = actionMap.at(ac);
+            if (!stat.visited() || stat.value() + bound(stat) >= bestLowerBound) { return false; }
+        }
+        return true;
+    }
+    return false;
 }
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
@@ -71,6 +136,18 @@ NodeId Solver<ProblemType, SelectionPolicy, RolloutPolicy>::selection()
 {
     const Node* currentNode = &tree_.root();
     NodeId currentNodeId{0};
+    path_.clear();
+    pendingEvent_ = NO_EVENT;
+
+    if (params_.rootStrategy == RootStrategy::SEQUENTIAL_HALVING && !currentNode->isTerminal() &&
+        !currentNode->isLeaf())
+    {
+        const auto& statistics = std::get<DecisionNode>(currentNode->payload).statistics;
+        const size_t rootAction = rootSchedule_.next(statistics, currentNode->outgoingEdges.size());
+        path_.push_back(currentNode->outgoingEdges[rootAction]);
+        currentNodeId = tree_[path_.back()].child;
+        currentNode = &tree_[currentNodeId];
+    }
 
     // Selection
     while (true)
@@ -88,8 +165,19 @@ NodeId Solver<ProblemType, SelectionPolicy, RolloutPolicy>::selectionOnce(const
     if (node.isTerminal() || node.isLeaf()) { return INVALID_NODE; }
     auto bestChild = selectionPolicy_.selectSuccessor(node);
     assert(bestChild != std::numeric_limits<size_t>::max());
-    auto selectedNodeId = tree_[node.outgoingEdges[bestChild]].child;
-    return selectedNodeId;
+    if (params_.lazyChanceExpansion && node.isChance())
+    {
+        // the selection policy samples an event, whose child might not exist yet
+        const uint8_t edgeIndex = std::get<ChanceNode>(node.payload).eventEdges[bestChild];
+        if (edgeIndex == ChanceNode::NOT_EXPANDED)
+        {
+            pendingEvent_ = bestChild;
+            return INVALID_NODE;
+        }
+        bestChild = edgeIndex;
+    }
+    path_.push_back(node.outgoingEdges[bestChild]);
+    return tree_[path_.back()].child;
 }
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
@@ -103,33 +191,75 @@ template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy
 void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::expansion(const Node& currentNode,
                                                                     Solver::DecisionNode& decNode)
 {
+    decNode.generateActions(currentNode.problem, currentNode.state);
     assert(!decNode.actions.empty());
 
+    if constexpr (ROLLOUT_IN_PLACE)
+    {
+        // a single copy of the state for all children, action and rollout are undone afterwards
+        const auto& problem = currentNode.problem;
+        auto state = currentNode.state;
+        for (const auto& action : decNode.actions)
+        {
+            const ValueVector nodeValue = currentNode.nodeValue + problem.performAction(action, state);
+            const EdgeId edgeId = insertChild(currentNode, state, nodeValue);
+            const ValueVector values =
+                tree_[tree_[edgeId].child].nodeValue + rolloutPolicy_.rolloutInPlace(state, problem);
+            problem.undoAction(action, state);
+            backpropagate(edgeId, values);
+        }
+        return;
+    }
+
     for (const auto& action : decNode.actions)
     {
         auto newState = currentNode.state;
         ValueVector rewards = currentNode.problem.performAction(action, newState);
-
-        Node newNode(currentNode.problem, newState);
-        newNode.nodeValue = currentNode.nodeValue + rewards;
-        auto [nodeId, edgeId] = tree_.insert(currentNode.nodeId, std::move(newNode));
-        (void)edgeId;
-        // Rollout to gain an estimate of the value of that node
-        auto values = rollout(nodeId);
-        // Backpropagate
-        backpropagate(nodeId, values);
+        insertChild(currentNode, newState, currentNode.nodeValue + rewards);
     }
+
+    // Rollout to gain an estimate of the value of the new nodes
+    const auto values = rolloutChildren(currentNode);
+    // Backpropagate
+    for (size_t idx = 0; idx < values.size(); ++idx) { backpropagate(currentNode.outgoingEdges[idx], values[idx]); }
 }
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
 void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::expansion(Solver::Node& currentNode,
                                                                     Solver::ChanceNode& chanceNode)
 {
+    if (chanceNode.events.empty()) { chanceNode.generateEvents(currentNode.problem, currentNode.state); }
     assert(!chanceNode.events.empty());
 
     if constexpr (ProblemType::HAS_CHANCE_EVENTS)
     {
+        if (params_.lazyChanceExpansion)
+        {
+            expandChanceEvent(currentNode, chanceNode);
+            return;
+        }
+        // all events are expanded in their order
+        std::iota(chanceNode.eventEdges.begin(), chanceNode.eventEdges.begin() + chanceNode.events.size(), 0);
+    }
+
+    if constexpr (ProblemType::HAS_CHANCE_EVENTS && ROLLOUT_IN_PLACE)
+    {
+        const auto& problem = currentNode.problem;
+        auto state = currentNode.state;
         ValueVector values{};
+        for (const auto& event : chanceNode.events)
+        {
+            const ValueVector nodeValue = currentNode.nodeValue + problem.performChanceEvent(event.second, state);
+            auto [nodeId, edgeId] = tree_.insert(currentNode.nodeId, Node(problem, state));
+            (void)edgeId;
+            tree_[nodeId].nodeValue = nodeValue;
+            values = values + event.first * (nodeValue + rolloutPolicy_.rolloutInPlace(state, problem));
+            problem.undoChanceEvent(event.second, state);
+        }
+        backpropagate(values);
+    }
+    else if constexpr (ProblemType::HAS_CHANCE_EVENTS)
+    {
         for (const auto& event : chanceNode.events)
         {
             auto newState = currentNode.state;
@@ -137,13 +267,75 @@ void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::expansion(Solver::Node
 
             Node newNode(currentNode.problem, newState);
             newNode.nodeValue = currentNode.nodeValue + rewards;
-            auto [nodeId, edgeId] = tree_.insert(currentNode.nodeId, std::move(newNode));
-            (void)edgeId;
-            // Rollout to gain an estimate of the value of that node
-            values = values + event.first * rollout(nodeId);
+            tree_.insert(currentNode.nodeId, std::move(newNode));
+        }
+
+        // Rollout to gain an estimate of the value of the new nodes
+        const auto childValues = rolloutChildren(currentNode);
+        ValueVector values{};
+        for (size_t idx = 0; idx < childValues.size(); ++idx)
+        {
+            values = values + chanceNode.events[idx].first * childValues[idx];
         }
         // Backpropagate
-        backpropagate(currentNode.nodeId, values);
+        backpropagate(values);
+    }
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::expandChanceEvent(Solver::Node& currentNode,
+                                                                            Solver::ChanceNode& chanceNode)
+{
+    // on the first visit of the chance node, selection stopped before sampling an event
+    const size_t event = pendingEvent_ != NO_EVENT ? pendingEvent_ : selectionPolicy_.selectSuccessor(currentNode);
+    pendingEvent_ = NO_EVENT;
+    assert(chanceNode.eventEdges[event] == ChanceNode::NOT_EXPANDED);
+
+    auto newState = currentNode.state;
+    const ValueVector rewards = currentNode.problem.performChanceEvent(chanceNode.events[event].second, newState);
+    auto [nodeId, edgeId] = tree_.insert(currentNode.nodeId, Node(currentNode.problem, newState));
+    tree_[nodeId].nodeValue = currentNode.nodeValue + rewards;
+    chanceNode.eventEdges[event] = tree_[edgeId].index;
+    backpropagate(edgeId, rollout(nodeId));
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+EdgeId Solver<ProblemType, SelectionPolicy, RolloutPolicy>::insertChild(const Node& parent, const StateType& state,
+                                                                        const ValueVector& nodeValue)
+{
+    const auto& problem = parent.problem;
+    if constexpr (CAN_SHARE_AFTERSTATES)
+    {
+        if (params_.shareAfterstates && problem.getNextStageType(state) == StageType::CHANCE)
+        {
+            // the id the node gets if it is inserted below
+            const NodeId newId{static_cast<typename TreeType::IndexType>(tree_.nodeCount())};
+            const auto [it, inserted] = afterstates_.try_emplace(state, newId);
+            if (!inserted)
+            {
+                ValueVector offset = nodeValue;
+                offset -= tree_[it->second].nodeValue;
+                return tree_.link(parent.nodeId, it->second, offset);
+            }
+        }
+    }
+
+    auto [nodeId, edgeId] = tree_.insert(parent.nodeId, Node(problem, state));
+    tree_[nodeId].nodeValue = nodeValue;
+    return edgeId;
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::indexAfterstates()
+{
+    if constexpr (CAN_SHARE_AFTERSTATES)
+    {
+        afterstates_.clear();
+        if (!params_.shareAfterstates) { return; }
+        for (const auto& node : tree_)
+        {
+            if (node.isChance()) { afterstates_.try_emplace(node.state, node.nodeId); }
+        }
     }
 }
 
@@ -158,15 +350,43 @@ template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy
 typename Solver<ProblemType, SelectionPolicy, RolloutPolicy>::ValueVector
 Solver<ProblemType, SelectionPolicy, RolloutPolicy>::rollout(NodeId nodeId)
 {
+    // a single state, so batch policies roll out with their scalar rollout as well
     auto& currentNode = tree_[nodeId];
     return currentNode.nodeValue + rolloutPolicy_.rollout(currentNode.state, currentNode.problem);
 }
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
-std::vector<std::pair<typename ProblemType::ActionType, Statistic<typename ProblemType::ValueType> > >
+zbo::MaxSizeVector<typename ProblemType::ValueVector, Solver<ProblemType, SelectionPolicy, RolloutPolicy>::MAX_CHILDREN>
+Solver<ProblemType, SelectionPolicy, RolloutPolicy>::rolloutChildren(const Node& node)
+{
+    zbo::MaxSizeVector<ValueVector, MAX_CHILDREN> values{};
+    if constexpr (detail::HAS_ROLLOUT_BATCH<RolloutPolicy, ProblemType>)
+    {
+        std::array<const StateType*, MAX_CHILDREN> states{};
+        std::array<ValueVector, MAX_CHILDREN> rolloutValues{};
+        for (size_t idx = 0; idx < node.outgoingEdges.size(); ++idx)
+        {
+            states.at(idx) = &tree_[tree_[node.outgoingEdges[idx]].child].state;
+        }
+        rolloutPolicy_.rolloutBatch(states.data(), node.outgoingEdges.size(), node.problem, rolloutValues.data());
+        for (size_t idx = 0; idx < node.outgoingEdges.size(); ++idx)
+        {
+            values.push_back(tree_[tree_[node.outgoingEdges[idx]].child].nodeValue + rolloutValues.at(idx));
+        }
+    }
+    else
+    {
+        for (const auto& edge : node.outgoingEdges) { values.push_back(rollout(tree_[edge].child)); }
+    }
+    return values;
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+std::vector<std::pair<typename ProblemType::ActionType,
+                      typename Solver<ProblemType, SelectionPolicy, RolloutPolicy>::StatisticType> >
 Solver<ProblemType, SelectionPolicy, RolloutPolicy>::getTopLevelUtilities() const
 {
-    std::vector<std::pair<typename ProblemType::ActionType, Statistic<typename ProblemType::ValueType> > > retval{};
+    std::vector<std::pair<typename ProblemType::ActionType, StatisticType> > retval{};
 
     const auto& rootNode = tree_.root();
 
@@ -195,8 +415,11 @@ void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::printTopLevelUtilities
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
 void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::init(const ProblemType& problem, const StateType& root)
 {
-    tree_.reserve(params_.numIterations * std::max(ProblemType::MAX_NUM_ACTIONS, ProblemType::MAX_CHANCE_EVENTS));
+    // every iteration adds the children of at most one node, plus the root. Nodes are referenced during the iterations,
+    // so they must never be reallocated
+    tree_.reserve(params_.numIterations * MAX_CHILDREN + 1);
     tree_.setRoot(Node{problem, root, DecisionNode{problem, root}});
+    indexAfterstates();
     currentIteration_ = 0;
 }
 
@@ -207,7 +430,7 @@ void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::iteration()
     auto selectedNodeId = selection();
     assert(selectedNodeId != INVALID_NODE);
     const auto& selectedNode = tree_[selectedNodeId];
-    if (selectedNode.isTerminal()) { backpropagate(selectedNodeId, selectedNode.nodeValue); }
+    if (selectedNode.isTerminal()) { backpropagate(selectedNode.nodeValue); }
     else
     {
         // expand all actions/chance events for this particular node to gain an estimate
@@ -216,23 +439,24 @@ void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::iteration()
 }
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
-void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::backpropagate(const NodeId& expandedNode,
-                                                                        const Solver::ValueVector& values)
+void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::backpropagate(Solver::ValueVector values)
 {
-    auto currentNodeId = expandedNode;
-    while (true)
+    for (auto edgeId = path_.rbegin(); edgeId != path_.rend(); ++edgeId)
     {
-        if (currentNodeId == ROOT_NODE) { break; }
-
-        // traverse the tree upward, as its a tree only one parent can be present
-        const auto& currentNode = tree_[currentNodeId];
-        const auto& edge = tree_[currentNode.incomingEdge];
-        const auto parentNodeId = edge.parent;
-        auto& parentNode = tree_[parentNodeId];
-        visitBackpropagate(parentNode, edge, values);
-        currentNodeId = parentNodeId;
+        const auto& edge = tree_[*edgeId];
+        if (edge.linked) { values = values + tree_.offset(*edgeId); }
+        visitBackpropagate(tree_[edge.parent], edge, values);
     }
-}  // namespace mcts
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::backpropagate(EdgeId newEdge,
+                                                                        const Solver::ValueVector& values)
+{
+    path_.push_back(newEdge);
+    backpropagate(values);
+    path_.pop_back();
+}
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
 void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::visitBackpropagate(Solver::ChanceNode&, const Edge&,
@@ -261,25 +485,44 @@ void Solver<ProblemType, SelectionPolicy, RolloutPolicy>::visitBackpropagate(Sol
 }
 
 template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
-typename Solver<ProblemType, SelectionPolicy, RolloutPolicy>::ActionType
-Solver<ProblemType, SelectionPolicy, RolloutPolicy>::currentBestAction() const
+size_t Solver<ProblemType, SelectionPolicy, RolloutPolicy>::bestActionIndex() const
 {
     const auto& rootNode = tree_.root();
     const auto& decisionNode = std::get<0>(rootNode.payload);
     const auto& actionMap = decisionNode.statistics.getStatistics();
 
+    if (params_.rootStrategy == RootStrategy::SEQUENTIAL_HALVING && !rootSchedule_.remainingActions().empty())
+    {
+        return rootSchedule_.best(decisionNode.statistics);
+    }
+
+    const bool byVisits = params_.finalSelection == FinalSelection::MAX_VISITS;
+
     size_t bestAction = std::numeric_limits<uint8_t>::max();
+    uint32_t bestCount = 0;
     ValueType bestValue = std::numeric_limits<ValueType>::lowest();
     for (size_t ac = 0; ac < actionMap.size(); ac++)
     {
-        if (!actionMap.at(ac).visited()) { continue; }
-        if (actionMap.at(ac).value() > bestValue)
+        const auto& stat = actionMap.at(ac);
+        if (!stat.visited()) { continue; }
+        // for max visits, ties are broken by the mean value
+        const bool moreVisits = stat.count() > bestCount || (stat.count() == bestCount && stat.value() > bestValue);
+        if (byVisits ? moreVisits : stat.value() > bestValue)
         {
-            bestValue = actionMap.at(ac).value();
+            bestValue = stat.value();
+            bestCount = stat.count();
             bestAction = ac;
         }
     }
-    return decisionNode.actions[bestAction];
+    return bestAction;
+}
+
+template <typename ProblemType, typename SelectionPolicy, typename RolloutPolicy>
+typename Solver<ProblemType, SelectionPolicy, RolloutPolicy>::ActionType
+Solver<ProblemType, SelectionPolicy, RolloutPolicy>::currentBestAction() const
+{
+    const auto& decisionNode = std::get<0>(tree_.root().payload);
+    return decisionNode.actions[bestActionIndex()];
 }
 
 }  // namespace mcts
@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "mcts/types.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace mcts {
+
+/**
+ * @brief Depth limited expectimax search for single player problems with chance events.
+ * Decision nodes take the maximum over all available actions, chance nodes the probability weighted mean over all
+ * available chance events. The search stops at maxDepth decisions or when the probability of reaching a state drops
+ * below minProbability and evaluates the state with the leaf heuristic instead.
+ *
+ * Values of decision states are cached in a transposition table keyed by KeyFunction and reused as long as they were
+ * computed with at least the remaining depth and at least the current probability, so that values with subtrees cut
+ * by minProbability are not reused on more likely paths. The cache lives for a single call to run().
+ *
+ * @tparam ProblemType problem as used by the Solver
+ * @tparam Heuristic functor ValueType(const StateType&, const ProblemType&) estimating the future reward of a state
+ * @tparam KeyFunction functor returning a hashable key that identifies a decision state
+ */
+template <typename ProblemType, typename Heuristic, typename KeyFunction>
+class ExpectimaxSolver
+{
+  public:
+    using StateType = typename ProblemType::StateType;
+    using ActionType = typename ProblemType::ActionType;
+    using ValueType = typename ProblemType::ValueType;
+    using KeyType = std::decay_t<std::invoke_result_t<KeyFunction, const StateType&>>;
+
+    static_assert(ProblemType::NUM_PLAYERS == 1, "Expectimax is only implemented for single player problems");
+
+    struct Parameter
+    {
+        size_t maxDepth = 2;          ///< number of decisions that are searched before the heuristic is evaluated, > 0
+        float minProbability = 1e-4;  ///< chance branches below this probability are evaluated by the heuristic
+        bool useCache = true;         ///< if false, the transposition cache is not used
+    };
+
+    struct Statistics
+    {
+        size_t numNodes{0};         ///< number of decision states that have been evaluated
+        size_t numHeuristics{0};    ///< number of heuristic evaluations
+        size_t numCacheHits{0};     ///< number of decision states that were taken from the cache
+        size_t numCacheLookups{0};  ///< number of cache lookups
+    };
+
+    explicit ExpectimaxSolver(Heuristic heuristic = {}, KeyFunction key = {})
+        : heuristic_(std::move(heuristic)), key_(std::move(key))
+    {
+    }
+
+    ExpectimaxSolver(const Parameter& param, Heuristic heuristic = {}, KeyFunction key = {})
+        : param_(param), heuristic_(std::move(heuristic)), key_(std::move(key))
+    {
+        assert(param_.maxDepth > 0);
+    }
+
+    /// returns the action with the highest expected value in the given non terminal decision state
+    ActionType run(const ProblemType& problem, const StateType& state)
+    {
+        assert(param_.maxDepth > 0);
+        assert(!problem.isTerminal(state));
+        assert(problem.getNextStageType(state) == StageType::DECISION);
+
+        cache_.clear();
+        statistics_ = {};
+        problem_ = &problem;
+
+        const auto actions = problem.getAvailableActions(state);
+        assert(!actions.empty());
+        ActionType bestAction = actions[0];
+        ValueType bestValue = std::numeric_limits<ValueType>::lowest();
+        for (const auto action : actions)
+        {
+            const ValueType value = actionValue(state, action, param_.maxDepth, 1.0F);
+            if (value > bestValue)
+            {
+                bestValue = value;
+                bestAction = action;
+            }
+        }
+        rootValue_ = bestValue;
+        problem_ = nullptr;
+        return bestAction;
+    }
+
+    [[nodiscard]] ValueType rootValue() const { return rootValue_; }
+    [[nodiscard]] const Statistics& statistics() const { return statistics_; }
+    [[nodiscard]] const Parameter& parameter() const { return param_; }
+    Parameter& parameter() { return param_; }
+
+  private:
+    struct CacheEntry
+    {
+        size_t depth;
+        float probability;  ///< probability of the path the value was computed on, decides where minProbability cuts
+        ValueType value;
+    };
+
+    ValueType actionValue(const StateType& state, const ActionType action, size_t depth, float probability)
+    {
+        StateType next = state;
+        const ValueType reward = problem_->performAction(action, next);
+        return reward + value(next, depth - 1, probability);
+    }
+
+    /// expected future reward of a state that can either be a decision or a chance state
+    ValueType value(const StateType& state, size_t depth, float probability)
+    {
+        if constexpr (ProblemType::HAS_CHANCE_EVENTS)
+        {
+            if (problem_->getNextStageType(state) == StageType::CHANCE)
+            {
+                return chanceValue(state, depth, probability);
+            }
+        }
+        return decisionValue(state, depth, probability);
+    }
+
+    ValueType chanceValue(const StateType& state, size_t depth, float probability)
+    {
+        ValueType sum{};
+        for (const auto& [eventProbability, event] : problem_->getAvailableChanceEvents(state))
+        {
+            StateType next = state;
+            const ValueType reward = problem_->performChanceEvent(event, next);
+            sum += eventProbability * (reward + value(next, depth, probability * eventProbability));
+        }
+        return sum;
+    }
+
+    ValueType decisionValue(const StateType& state, size_t depth, float probability)
+    {
+        if (problem_->isTerminal(state)) { return ValueType{}; }
+        if (depth == 0 || probability < param_.minProbability)
+        {
+            statistics_.numHeuristics++;
+            return heuristic_(state, *problem_);
+        }
+
+        KeyType key{};
+        if (param_.useCache)
+        {
+            key = key_(state);
+            statistics_.numCacheLookups++;
+            const auto it = cache_.find(key);
+            if (it != cache_.end() && it->second.depth >= depth && it->second.probability >= probability)
+            {
+                statistics_.numCacheHits++;
+                return it->second.value;
+            }
+        }
+
+        statistics_.numNodes++;
+        ValueType best = std::numeric_limits<ValueType>::lowest();
+        for (const auto action : problem_->getAvailableActions(state))
+        {
+            best = std::max(best, actionValue(state, action, depth, probability));
+        }
+
+        if (param_.useCache)
+        {
+            // an earlier entry that was searched deeper or on a more likely path is kept
+            const auto [it, inserted] = cache_.try_emplace(key, CacheEntry{depth, probability, best});
+            if (!inserted && depth >= it->second.depth && probability >= it->second.probability)
+            {
+                it->second = CacheEntry{depth, probability, best};
+            }
+        }
+        return best;
+    }
+
+    Parameter param_{};
+    Heuristic heuristic_;
+    KeyFunction key_;
+
+    const ProblemType* problem_{nullptr};
+    std::unordered_map<KeyType, CacheEntry> cache_{};
+    Statistics statistics_{};
+    ValueType rootValue_{};
+};
+}  // namespace mcts
@@ -0,0 +1,148 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace mcts {
+namespace detail {
+/// cell permutations of the 8 symmetries of a square grid, see GridSymmetry
+template <size_t SIZE>
+constexpr std::array<std::array<uint8_t, SIZE * SIZE>, 8> createGridPermutations()
+{
+    std::array<std::array<uint8_t, SIZE * SIZE>, 8> permutations{};
+    for (size_t symmetry = 0; symmetry < permutations.size(); ++symmetry)
+    {
+        for (size_t y = 0; y < SIZE; ++y)
+        {
+            for (size_t x = 0; x < SIZE; ++x)
+            {
+                size_t newX = (symmetry & 4U) != 0 ? y : x;
+                size_t newY = (symmetry & 4U) != 0 ? x : y;
+                if ((symmetry & 1U) != 0) { newX = SIZE - 1 - newX; }
+                if ((symmetry & 2U) != 0) { newY = SIZE - 1 - newY; }
+                permutations[symmetry][y * SIZE + x] = static_cast<uint8_t>(newY * SIZE + newX);
+            }
+        }
+    }
+    return permutations;
+}
+}  // namespace detail
+
+/**
+ * @brief The 8 symmetries of a square grid (rotations and reflections, the dihedral group D4) acting on bitmasks of
+ * cells, where bit y * SIZE + x is the cell in column x and row y.
+ * Symmetry s first transposes the grid if bit 2 is set, then mirrors the columns (bit 0) and rows (bit 1). Sets of
+ * symmetries are passed around as bitsets with bit s for symmetry s, symmetry 0 is the identity.
+ * Games on square boards use it to only expand one of several equivalent moves and to compute a canonical key of
+ * a position that is equal for all symmetric positions.
+ */
+template <size_t SIZE, typename MaskType = uint64_t>
+class GridSymmetry
+{
+  public:
+    static constexpr size_t NUM_CELLS = SIZE * SIZE;
+    static constexpr size_t NUM_SYMMETRIES = 8;
+    static_assert(NUM_CELLS <= sizeof(MaskType) * 8, "Cells do not fit into the mask");
+
+    using SymmetrySet = uint8_t;
+    static constexpr SymmetrySet IDENTITY = 1U;
+    static constexpr SymmetrySet ALL = 0xFFU;
+
+    /// cell that the given cell is mapped to by the symmetry
+    static constexpr size_t transformCell(size_t symmetry, size_t cell) { return PERMUTATIONS[symmetry][cell]; }
+
+    /// mask of the cells mapped by the symmetry
+    static constexpr MaskType transform(size_t symmetry, MaskType mask)
+    {
+        MaskType result = 0;
+        for (; mask != 0; mask &= mask - 1)
+        {
+            result |= MaskType(1) << PERMUTATIONS[symmetry][__builtin_ctzll(mask)];
+        }
+        return result;
+    }
+
+    /// all symmetries that map every one of the masks (e.g. the stones of each player) onto itself
+    static constexpr SymmetrySet stabilizer(std::initializer_list<MaskType> masks)
+    {
+        SymmetrySet symmetries = IDENTITY;
+        for (size_t symmetry = 1; symmetry < NUM_SYMMETRIES; ++symmetry)
+        {
+            bool invariant = true;
+            for (const MaskType mask : masks) { invariant = invariant && transform(symmetry, mask) == mask; }
+            if (invariant) { symmetries |= SymmetrySet(1U << symmetry); }
+        }
+        return symmetries;
+    }
+
+    /// one cell (the one with the lowest index) of every class of cells that are equivalent under the symmetries.
+    /// The symmetries have to map the given cells onto themselves, which holds for the empty cells and the stabilizer
+    static constexpr MaskType representatives(MaskType cells, SymmetrySet symmetries)
+    {
+        if (symmetries == IDENTITY) { return cells; }
+        MaskType result = 0;
+        for (MaskType remaining = cells; remaining != 0; remaining &= remaining - 1)
+        {
+            const size_t cell = __builtin_ctzll(remaining);
+            bool lowest = true;
+            for (size_t symmetry = 1; symmetry < NUM_SYMMETRIES && lowest; ++symmetry)
+            {
+                if ((symmetries >> symmetry) & 1U) { lowest = transformCell(symmetry, cell) >= cell; }
+            }
+            if (lowest) { result |= MaskType(1) << cell; }
+        }
+        return result;
+    }
+
+    /// the lexicographically smallest of the 8 transformations of the masks, equal for all symmetric positions
+    template <size_t N>
+    static constexpr std::array<MaskType, N> canonical(const std::array<MaskType, N>& masks)
+    {
+        std::array<MaskType, N> best = masks;
+        for (size_t symmetry = 1; symmetry < NUM_SYMMETRIES; ++symmetry)
+        {
+            std::array<MaskType, N> transformed{};
+            for (size_t i = 0; i < N; ++i) { transformed[i] = transform(symmetry, masks[i]); }
+            if (isLess(transformed, best)) { best = transformed; }
+        }
+        return best;
+    }
+
+  private:
+    template <size_t N>
+    static constexpr bool isLess(const std::array<MaskType, N>& lhs, const std::array<MaskType, N>& rhs)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (lhs[i] != rhs[i]) { return lhs[i] < rhs[i]; }
+        }
+        return false;
+    }
+
+    static constexpr auto PERMUTATIONS = detail::createGridPermutations<SIZE>();
+};
+}  // namespace mcts
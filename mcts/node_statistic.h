@@ -25,6 +25,7 @@
 #include "types.h"
 
 #include <array>
+#include <cmath>
 #include <limits>
 
 namespace mcts {
@@ -51,26 +52,53 @@ struct Statistic
     ValueType maxValue_ = std::numeric_limits<ValueType>::lowest();
 };
 
+/**
+ * Statistic that additionally tracks the variance of all added values using Welford's online algorithm.
+ * Opt-in for selection policies that need the variance (e.g. UCB1-Tuned or UCB-V), as it costs one extra accumulator
+ */
+template <typename ValueType>
+struct VarianceStatistic
+{
+    void add(const ValueType& value)
+    {
+        count_++;
+        const ValueType delta = value - mean_;
+        mean_ += delta / ValueType(count_);
+        sumSquaredDiff_ += delta * (value - mean_);
+        maxValue_ = std::max(maxValue_, value);
+    }
+
+    [[nodiscard]] ValueType value() const noexcept { return mean_; }
+    [[nodiscard]] uint32_t count() const noexcept { return count_; }
+    [[nodiscard]] ValueType max() const noexcept { return maxValue_; }
+    [[nodiscard]] bool visited() const noexcept { return count_ != 0; }
+
+    /// population variance of all added values
+    [[nodiscard]] ValueType variance() const noexcept { return sumSquaredDiff_ / ValueType(std::max(1U, count_)); }
+    [[nodiscard]] ValueType standardDeviation() const noexcept { return std::sqrt(variance()); }
+
+  private:
+    ValueType mean_ = 0.0;
+    ValueType sumSquaredDiff_ = 0.0;
+    uint32_t count_ = 0;
+    ValueType maxValue_ = std::numeric_limits<ValueType>::lowest();
+};
+
 /**
  * This class holds all statistics for each discrete choices.
  * This could be either actions, events, edges, etc. Something with integer IDs
  * :) Unfortunately, it is the callers responsibility not to mix different ids.
  */
-template <typename ValueType, int maxNumStatistics>
+template <typename ValueType, int maxNumStatistics, typename StatisticType = Statistic<ValueType>>
 class NodeStatistic
 {
   public:
-    using Stat = Statistic<ValueType>;
+    using Stat = StatisticType;
     NodeStatistic() { statistics_.fill(Stat()); };
 
     [[nodiscard]] uint32_t getTotalVisits() const { return visitCount_; }
 
-    void initializeValue(size_t idx)
-    {
-        statistics_[idx].total_value = 0;
-        statistics_[idx].count = 0;
-        statistics_[idx].max_value = std::numeric_limits<ValueType>::lowest();
-    }
+    void initializeValue(size_t idx) { statistics_[idx] = Stat(); }
 
     void visitWithValue(size_t idx, const ValueType& val)
     {
@@ -0,0 +1,202 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace mcts {
+
+/// Mixing function of the SplitMix64 generator, turns consecutive numbers into well distributed seeds
+inline uint64_t splitMix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27U)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31U);
+}
+
+namespace detail {
+inline uint64_t& threadStream()
+{
+    static std::atomic<uint64_t> nextStream{0};
+    thread_local uint64_t stream = nextStream++;
+    return stream;
+}
+
+inline uint64_t nextEngineId()
+{
+    static std::atomic<uint64_t> nextId{0};
+    return nextId++;
+}
+
+/// Engines of the calling thread by id of the ThreadLocalEngine, with a direct mapped cache in front of the map, as
+/// problem and policies usually draw alternately in a rollout
+struct ThreadEngines
+{
+    using Engine = std::minstd_rand0;
+
+    struct Entry
+    {
+        Engine engine;
+        uint64_t generation;  ///< the seed() call the engine was seeded for
+    };
+
+    struct CacheEntry
+    {
+        uint64_t id{};
+        uint64_t generation{};
+        Engine* engine{nullptr};
+    };
+
+    static constexpr size_t CACHE_SIZE = 8;
+
+    ThreadEngines() { alive() = true; }
+    ThreadEngines(const ThreadEngines&) = delete;
+    ThreadEngines& operator=(const ThreadEngines&) = delete;
+    ~ThreadEngines() { alive() = false; }
+
+    static ThreadEngines& get()
+    {
+        thread_local ThreadEngines engines{};
+        return engines;
+    }
+
+    /// false before the engines of the calling thread are created and once they are destroyed at thread exit
+    static bool& alive()
+    {
+        thread_local bool isAlive = false;
+        return isAlive;
+    }
+
+    CacheEntry& cached(uint64_t id)
+    {
+        return cache[id % CACHE_SIZE];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    /// releases the engine of the given id in the calling thread
+    static void release(uint64_t id)
+    {
+        if (!alive()) { return; }
+        auto& engines = get();
+        auto& cachedEntry = engines.cached(id);
+        if (cachedEntry.id == id) { cachedEntry = {}; }
+        engines.map.erase(id);
+    }
+
+    std::unordered_map<uint64_t, Entry> map{};
+    std::array<CacheEntry, CACHE_SIZE> cache{};
+};
+
+/// Id of the engines of a ThreadLocalEngine and its copies, the thread that destroys the last copy releases its engine
+class EngineId
+{
+  public:
+    EngineId() = default;
+    EngineId(const EngineId&) = delete;
+    EngineId& operator=(const EngineId&) = delete;
+    ~EngineId() { ThreadEngines::release(value); }
+
+    const uint64_t value{nextEngineId()};
+};
+}  // namespace detail
+
+/// Stream index of the calling thread. Threads are numbered in the order in which they first draw a random number,
+/// unless the index is set explicitly with setThreadStream
+inline uint64_t threadStream()
+{
+    return detail::threadStream();
+}
+
+/// Sets the stream index of the calling thread. Worker threads that set their index before drawing any random numbers
+/// get reproducible random numbers, no matter in which order they are started
+inline void setThreadStream(uint64_t stream)
+{
+    detail::threadStream() = stream;
+}
+
+/**
+ * @brief Random engine that holds a separate engine for every thread, so that const methods of a problem or policy can
+ * draw random numbers from several threads at once without data races.
+ *
+ * The engine of a thread is seeded from the seed and the stream index of the thread (see setThreadStream), so results
+ * are reproducible as long as every thread has a fixed stream index. Copies share the engines of the original, so the
+ * copies of a problem in the nodes of a tree continue the same random sequence instead of repeating it.
+ *
+ * The engines live in thread local storage. When the last copy is destroyed, the engine of the destroying thread is
+ * released, engines of other threads only when their thread ends. Creating and seeding engines in a long living thread
+ * (e.g. a solver per move on the main thread) thus keeps a constant number of engines, while threads that outlive
+ * many engines created elsewhere keep one engine per engine they drew from.
+ */
+class ThreadLocalEngine
+{
+  public:
+    using Engine = detail::ThreadEngines::Engine;
+
+    explicit ThreadLocalEngine(uint64_t seed = 0) : seed_(seed) {}
+
+    /// The engine of the calling thread
+    Engine& get() const
+    {
+        auto& engines = detail::ThreadEngines::get();
+        auto& cached = engines.cached(id_);
+        if (cached.engine != nullptr && cached.id == id_ && cached.generation == generation_) { return *cached.engine; }
+
+        auto it = engines.map.find(id_);
+        if (it == engines.map.end() || it->second.generation != generation_)
+        {
+            const auto seed = splitMix64(seed_ ^ splitMix64(threadStream()));
+            const Engine engine(static_cast<Engine::result_type>(seed));
+            it = engines.map.insert_or_assign(id_, detail::ThreadEngines::Entry{engine, generation_}).first;
+        }
+        cached = {id_, generation_, &it->second.engine};
+        return it->second.engine;
+    }
+
+    Engine::result_type operator()() const { return get()(); }
+
+    /// Restarts the random sequences of all threads with the new seed. Must not be called while other threads draw.
+    /// Copies made before keep drawing from the previous sequences
+    void seed(uint64_t seed)
+    {
+        seed_ = seed;
+        if (owner_.use_count() == 1) { generation_++; }  // engines of other threads are reseeded on their next draw
+        else
+        {
+            owner_ = std::make_shared<const detail::EngineId>();
+            id_ = owner_->value;
+        }
+    }
+
+  private:
+    uint64_t seed_;
+    uint64_t generation_{0};
+    std::shared_ptr<const detail::EngineId> owner_{std::make_shared<const detail::EngineId>()};
+    uint64_t id_{owner_->value};
+};
+}  // namespace mcts
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #pragma once
+#include "mcts/random.h"
 #include "rollout.h"
 
 #include <cassert>
@@ -46,7 +47,7 @@ class RandomPolicy
     void seed(size_t seed) { engine_.seed(seed); }
 
   private:
-    std::minstd_rand0 engine_{std::random_device{}()};
+    ThreadLocalEngine engine_{std::random_device{}()};
 };
 
 using RandomRolloutPolicy = RolloutPolicy<RandomPolicy>;
@@ -22,12 +22,74 @@
 
 #pragma once
 
+#include "mcts/details/problem_impl.h"
+#include "mcts/random.h"
 #include "mcts/types.h"
 
+#include <cassert>
 #include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mcts {
 
+namespace detail {
+/// Detects rollout policies that evaluate several states at once, which the solver then uses for all children of an
+/// expansion. Single states (e.g. lazily expanded chance events) are still evaluated with rollout:
+///   void rolloutBatch(const StateType* const* states, size_t count, const ProblemType& problem, ValueVector* values);
+template <class Policy, class ProblemType, class = void>
+struct HasRolloutBatch : std::false_type
+{
+};
+
+template <class Policy, class ProblemType>
+struct HasRolloutBatch<Policy, ProblemType,
+                       std::void_t<decltype(std::declval<Policy&>().rolloutBatch(
+                           std::declval<const typename ProblemType::StateType* const*>(), size_t{},
+                           std::declval<const ProblemType&>(), std::declval<typename ProblemType::ValueVector*>()))>>
+    : std::true_type
+{
+};
+
+template <class Policy, class ProblemType>
+constexpr bool HAS_ROLLOUT_BATCH = HasRolloutBatch<Policy, ProblemType>::value;  // NOLINT(readability-identifier-naming)
+
+/// Detects rollout policies that play on the given state and restore it afterwards (see RolloutPolicy::rolloutInPlace):
+///   ValueVector rolloutInPlace(StateType& state, const ProblemType& problem);
+template <class Policy, class ProblemType, class = void>
+struct HasRolloutInPlace : std::false_type
+{
+};
+
+template <class Policy, class ProblemType>
+struct HasRolloutInPlace<Policy, ProblemType,
+                         std::void_t<decltype(std::declval<Policy&>().rolloutInPlace(
+                             std::declval<typename ProblemType::StateType&>(), std::declval<const ProblemType&>()))>>
+    : std::true_type
+{
+};
+
+template <class Policy, class ProblemType>
+constexpr bool HAS_ROLLOUT_IN_PLACE =  // NOLINT(readability-identifier-naming)
+    HasRolloutInPlace<Policy, ProblemType>::value;
+
+/// Detects policies with random decisions that can be seeded: void seed(uint64_t seed);
+template <class Policy, class = void>
+struct HasSeed : std::false_type
+{
+};
+
+template <class Policy>
+struct HasSeed<Policy, std::void_t<decltype(std::declval<Policy&>().seed(uint64_t{}))>> : std::true_type
+{
+};
+
+template <class Policy>
+constexpr bool HAS_SEED = HasSeed<Policy>::value;  // NOLINT(readability-identifier-naming)
+}  // namespace detail
+
 /**
  * @brief Class performing a rollout with a given depth (and a given discount factor) using the given (templated) policy
  * @tparam Policy policy to use. has to implement a getAction(state,problem) -> Action function in order to be called
@@ -40,6 +102,13 @@ class RolloutPolicy
     explicit RolloutPolicy(size_t depth, float discount = 1.0f) : rolloutDepth_(depth), discount_(discount){};
     RolloutPolicy(Policy&& policy) : policy_(std::move(policy)){};
 
+    /// Seeds the policy (if it can be seeded) and the sampling of chance events of rolloutInPlace
+    void seed(uint64_t seed)
+    {
+        if constexpr (detail::HAS_SEED<Policy>) { policy_.seed(seed); }
+        chanceEngine_.seed(static_cast<std::minstd_rand::result_type>(splitMix64(seed)));
+    }
+
     template <class ProblemType>
     typename ProblemType::ValueVector rollout(typename ProblemType::StateType state, const ProblemType& problem)
     {
@@ -72,9 +141,86 @@ class RolloutPolicy
         return retval;
     }
 
+    /**
+     * @brief Same as rollout, but plays directly on the given state and unwinds all actions and chance events
+     * afterwards, so the state is unchanged on return. Requires the undo interface of the problem
+     */
+    template <class ProblemType>
+    typename ProblemType::ValueVector rolloutInPlace(typename ProblemType::StateType& state, const ProblemType& problem)
+    {
+        static_assert(detail::SUPPORTS_UNDO<ProblemType>, "Problem has to implement undoAction/undoChanceEvent");
+
+        struct Step
+        {
+            StageType stage;
+            typename ProblemType::ActionType action;
+            typename ProblemType::ChanceEventType event;
+        };
+        // reused between rollouts to avoid allocations, one buffer per problem type and thread
+        thread_local std::vector<Step> trail{};
+        trail.clear();
+
+        typename ProblemType::ValueVector retval{};
+        size_t depth = 0;
+        float currDiscount = 1;
+        while (!problem.isTerminal(state))
+        {
+            switch (problem.getNextStageType(state))
+            {
+                case mcts::StageType::DECISION: {
+                    auto action = policy_.getAction(state, problem);
+                    auto reward = problem.performAction(action, state);
+                    retval = retval + currDiscount * reward;
+                    trail.push_back(Step{StageType::DECISION, action, {}});
+                    break;
+                }
+                case mcts::StageType::CHANCE: {
+                    if constexpr (ProblemType::HAS_CHANCE_EVENTS)
+                    {
+                        auto event = sampleChanceEvent(state, problem);
+                        auto reward = problem.performChanceEvent(event, state);
+                        retval = retval + currDiscount * reward;
+                        trail.push_back(Step{StageType::CHANCE, {}, event});
+                    }
+                    break;
+                }
+            }
+            depth++;
+            currDiscount *= discount_;
+            if (depth > rolloutDepth_) { break; }
+        }
+
+        for (auto step = trail.rbegin(); step != trail.rend(); ++step)
+        {
+            if (step->stage == StageType::DECISION) { problem.undoAction(step->action, state); }
+            else if constexpr (ProblemType::HAS_CHANCE_EVENTS)
+            {
+                problem.undoChanceEvent(step->event, state);
+            }
+        }
+        return retval;
+    }
+
   private:
+    /// performRandomChanceEvent does not tell which event happened, so we have to sample it ourselves for undoing it
+    template <class ProblemType>
+    typename ProblemType::ChanceEventType sampleChanceEvent(const typename ProblemType::StateType& state,
+                                                            const ProblemType& problem)
+    {
+        const auto events = problem.getAvailableChanceEvents(state);
+        assert(!events.empty());
+        float sample = std::uniform_real_distribution<float>{}(chanceEngine_);
+        for (const auto& [probability, event] : events)
+        {
+            if (sample < probability) { return event; }
+            sample -= probability;
+        }
+        return events.back().second;
+    }
+
     size_t rolloutDepth_{std::numeric_limits<size_t>::max()};
     float discount_{1.0f};
     Policy policy_{};
+    std::minstd_rand chanceEngine_{std::random_device{}()};
 };
 }  // namespace mcts
\ No newline at end of file
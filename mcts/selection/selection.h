@@ -22,12 +22,32 @@
 
 #pragma once
 
+#include "mcts/node_statistic.h"
+
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <random>
+#include <type_traits>
 #include <variant>
 
 namespace mcts {
+
+namespace detail {
+/// Detects the statistic a selection policy needs per action (using StatisticType = ...), policies without one get the
+/// plain Statistic
+template <class Policy, class ValueType, class = void>
+struct SelectionStatistic
+{
+    using type = Statistic<ValueType>;
+};
+
+template <class Policy, class ValueType>
+struct SelectionStatistic<Policy, ValueType, std::void_t<typename Policy::StatisticType>>
+{
+    using type = typename Policy::StatisticType;
+};
+}  // namespace detail
 template <class T>
 class SelectionPolicy
 {
@@ -44,17 +64,10 @@ class SelectionPolicy
     size_t operator()(const Node&, const typename Node::ChanceNode& chance)
     {
         assert(!chance.events.empty());
+        assert(chance.sampler && chance.sampler->size() == chance.events.size());
 
-        float randVal = dist_(engine_);
-
-        size_t counter = 0;
-        for (const auto& ev : chance.events)
-        {
-            if (randVal < ev.first) { return counter; }
-            randVal -= ev.first;
-            counter++;
-        }
-        return chance.events.size() - 1;
+        // the engine yields 31 random bits, the sampler expects 32
+        return chance.sampler->sample(static_cast<uint32_t>(engine_() - std::minstd_rand0::min()) << 1U);
     }
 
     template <typename Node>
@@ -67,6 +80,5 @@ class SelectionPolicy
 
   private:
     std::minstd_rand0 engine_{std::random_device{}()};
-    std::uniform_real_distribution<float> dist_{0, 1.0f};
 };
 }  // namespace mcts
\ No newline at end of file
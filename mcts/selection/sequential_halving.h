@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace mcts {
+
+/**
+ * @brief Root action schedule based on sequential halving (Karnin et al. 2013, as used by Gumbel MuZero).
+ * The iteration budget is split into ceil(log2(numActions)) rounds. In each round, all remaining actions are visited
+ * equally often, afterwards the worse half (by mean value) is discarded. This spends small budgets on the promising
+ * root actions instead of on exploration
+ */
+class SequentialHalving
+{
+  public:
+    /// restarts the schedule with the given iteration budget, the root actions are known on the first call to next()
+    void reset(size_t budget)
+    {
+        budget_ = budget;
+        remaining_.clear();
+    }
+
+    /// returns the index of the root action that should be visited in the next iteration
+    template <typename Statistics>
+    size_t next(const Statistics& statistics, size_t numActions)
+    {
+        if (remaining_.empty()) { start(numActions); }
+        if (remaining_.size() > 1 && visitsInRound_ == visitsPerAction_ * remaining_.size()) { halve(statistics); }
+
+        const size_t action = remaining_[visitsInRound_ % remaining_.size()];
+        visitsInRound_++;
+        return action;
+    }
+
+    /// returns the best remaining root action by mean value or max if no schedule was started yet
+    template <typename Statistics>
+    [[nodiscard]] size_t best(const Statistics& statistics) const
+    {
+        size_t bestAction = std::numeric_limits<size_t>::max();
+        for (const auto action : remaining_)
+        {
+            if (!statistics.stat(action).visited()) { continue; }
+            if (bestAction == std::numeric_limits<size_t>::max() ||
+                statistics.stat(action).value() > statistics.stat(bestAction).value())
+            {
+                bestAction = action;
+            }
+        }
+        return bestAction;
+    }
+
+    [[nodiscard]] const std::vector<uint8_t>& remainingActions() const { return remaining_; }
+
+  private:
+    void start(size_t numActions)
+    {
+        assert(numActions > 0);
+        remaining_.resize(numActions);
+        std::iota(remaining_.begin(), remaining_.end(), 0);
+        numRounds_ = std::max(size_t(1), size_t(std::ceil(std::log2(double(numActions)))));
+        startRound();
+    }
+
+    void startRound()
+    {
+        visitsInRound_ = 0;
+        visitsPerAction_ = std::max(size_t(1), budget_ / (remaining_.size() * numRounds_));
+    }
+
+    template <typename Statistics>
+    void halve(const Statistics& statistics)
+    {
+        std::stable_sort(remaining_.begin(), remaining_.end(), [&statistics](uint8_t a1, uint8_t a2) {
+            return statistics.stat(a1).value() > statistics.stat(a2).value();
+        });
+        remaining_.resize((remaining_.size() + 1) / 2);
+        startRound();
+    }
+
+    size_t budget_{0};
+    size_t numRounds_{1};
+    size_t visitsPerAction_{1};
+    size_t visitsInRound_{0};
+    std::vector<uint8_t> remaining_{};
+};
+}  // namespace mcts
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #pragma once
+#include "mcts/node_statistic.h"
 #include "selection.h"
 
 #include <cassert>
@@ -40,6 +41,9 @@ class UCB1SelectionPolicy : public SelectionPolicy<UCB1SelectionPolicy<ValueType
   public:
     static_assert(std::is_arithmetic_v<ValueType>, "Value must be an arithmetic type");
 
+    /// the statistic this policy needs to be stored per action
+    using StatisticType = Statistic<ValueType>;
+
     struct Parameter
     {
         ValueType min{0};
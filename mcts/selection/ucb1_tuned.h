@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "mcts/node_statistic.h"
+#include "selection.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace mcts {
+
+/**
+ * @brief Find best child based on UCB1-Tuned (Auer et al. 2002), which bounds the exploration term by the empirical
+ * variance of each action. Low variance actions are explored less than with plain UCB1
+ * @tparam ValueType
+ */
+template <typename ValueType>
+class UCB1TunedSelectionPolicy : public SelectionPolicy<UCB1TunedSelectionPolicy<ValueType>>
+{
+  public:
+    static_assert(std::is_arithmetic_v<ValueType>, "Value must be an arithmetic type");
+
+    using StatisticType = VarianceStatistic<ValueType>;
+
+    struct Parameter
+    {
+        ValueType min{0};
+        ValueType max{1};
+        float explorationConstant{1};
+    };
+
+    UCB1TunedSelectionPolicy() = default;
+    UCB1TunedSelectionPolicy(const Parameter& params) : params_(params) {}
+
+    template <typename Node>
+    size_t selectDecisionNodeSuccessor(const Node&, const typename Node::DecisionNode& decision)
+    {
+        /// upper bound of the variance of a random variable in [0, 1]
+        constexpr float MAX_VARIANCE = 0.25f;
+
+        float bestUCTValue = std::numeric_limits<float>::lowest();
+
+        const auto& map = decision.statistics;
+        size_t bestChild = std::numeric_limits<size_t>::max();
+        size_t index = 0;
+
+        const float range = params_.max - params_.min;
+        const float invSquaredRange = 1.0f / (range * range);
+        const auto logVisits = logf(map.getTotalVisits());
+
+        for (const auto& m : map)
+        {
+            index++;
+
+            if (!m.visited()) { continue; }
+
+            const float count = float(m.count());
+            const float varianceBound = float(m.variance()) * invSquaredRange + std::sqrt(2 * logVisits / count);
+            float currentUTC = m.value() + params_.explorationConstant * range *
+                                               std::sqrt(logVisits / count * std::min(MAX_VARIANCE, varianceBound));
+
+            assert(!std::isnan(currentUTC));
+
+            if (currentUTC > bestUCTValue)
+            {
+                bestUCTValue = currentUTC;
+                bestChild = index - 1;
+            }
+        }
+        assert(bestChild != std::numeric_limits<size_t>::max());
+        return bestChild;
+    }
+
+  private:
+    Parameter params_{};
+};
+}  // namespace mcts
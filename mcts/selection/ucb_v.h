@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2020 Lenzebo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "mcts/node_statistic.h"
+#include "selection.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace mcts {
+
+/**
+ * @brief Find best child based on UCB-V (Audibert et al. 2009), an empirical Bernstein bound using the variance of
+ * each action:
+ *   value + sqrt(2 * variance * zeta * log(N) / n) + c * 3 * range * zeta * log(N) / n
+ * @tparam ValueType
+ */
+template <typename ValueType>
+class UCBVSelectionPolicy : public SelectionPolicy<UCBVSelectionPolicy<ValueType>>
+{
+  public:
+    static_assert(std::is_arithmetic_v<ValueType>, "Value must be an arithmetic type");
+
+    using StatisticType = VarianceStatistic<ValueType>;
+
+    struct Parameter
+    {
+        ValueType min{0};
+        ValueType max{1};
+        float zeta{1.2f};  // NOLINT
+        float explorationConstant{1.0f};
+    };
+
+    UCBVSelectionPolicy() = default;
+    UCBVSelectionPolicy(const Parameter& params) : params_(params) {}
+
+    template <typename Node>
+    size_t selectDecisionNodeSuccessor(const Node&, const typename Node::DecisionNode& decision)
+    {
+        float bestUCTValue = std::numeric_limits<float>::lowest();
+
+        const auto& map = decision.statistics;
+        size_t bestChild = std::numeric_limits<size_t>::max();
+        size_t index = 0;
+
+        const float range = params_.max - params_.min;
+        const float exploration = params_.zeta * logf(map.getTotalVisits());
+
+        for (const auto& m : map)
+        {
+            index++;
+
+            if (!m.visited()) { continue; }
+
+            const float count = float(m.count());
+            float currentUTC = m.value() + std::sqrt(2 * float(m.variance()) * exploration / count) +
+                               params_.explorationConstant * 3 * range * exploration / count;
+
+            assert(!std::isnan(currentUTC));
+
+            if (currentUTC > bestUCTValue)
+            {
+                bestUCTValue = currentUTC;
+                bestChild = index - 1;
+            }
+        }
+        assert(bestChild != std::numeric_limits<size_t>::max());
+        return bestChild;
+    }
+
+  private:
+    Parameter params_{};
+};
+}  // namespace mcts
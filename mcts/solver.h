@@ -24,6 +24,7 @@
 
 #include "node_statistic.h"
 #include "rollout/random_rollout.h"
+#include "selection/sequential_halving.h"
 #include "selection/ucb1.h"
 #include "tree.h"
 #include "zbo/max_size_vector.h"
@@ -32,10 +33,31 @@
 #include <atomic>
 #include <cmath>
 #include <random>
+#include <type_traits>
+#include <unordered_map>
 #include <variant>
 
 namespace mcts {
 
+/// How the actions of the root node are selected during the iterations
+enum class RootStrategy
+{
+    SELECTION_POLICY,   ///< the same selection policy as for all other nodes
+    SEQUENTIAL_HALVING  ///< split the iteration budget across root actions with sequential halving
+};
+
+/// How the final action is chosen from the statistics of the root node
+enum class FinalSelection
+{
+    MAX_VALUE,  ///< action with the highest mean value
+    MAX_VISITS  ///< action with the most visits ("robust child")
+};
+
+/**
+ * @brief Monte carlo tree search solver. If the problem implements undoAction/undoChanceEvent (see
+ * detail::SUPPORTS_UNDO) and the rollout policy provides rolloutInPlace, expansion and rollout work on a single state
+ * per expansion. Rollout policies with rolloutBatch take precedence, they evaluate all children of an expansion at once
+ */
 template <typename ProblemType, typename SelectionPolicy = UCB1SelectionPolicy<typename ProblemType::ValueType>,
           typename RolloutPolicy = RandomRolloutPolicy>
 class Solver
@@ -45,7 +67,8 @@ class Solver
     using ValueVector = typename ProblemType::ValueVector;
     using StateType = typename ProblemType::StateType;
     using ActionType = typename ProblemType::ActionType;
-    using TreeType = Tree<ProblemType>;
+    using TreeType = Tree<ProblemType, typename detail::SelectionStatistic<SelectionPolicy, ValueType>::type>;
+    using StatisticType = typename TreeType::StatisticType;
     using Node = typename TreeType::Node;
     using Edge = typename TreeType::Edge;
     using DecisionNode = typename Node::DecisionNode;
@@ -57,6 +80,26 @@ class Solver
         static constexpr size_t DEFAULT_ITERATIONS = 10000;
         /// maximal number of iterations the algorithm should run
         size_t numIterations = DEFAULT_ITERATIONS;
+        /// stop early once the most visited root action cannot be overtaken in visits by any other root action within
+        /// the remaining iterations. Only used with FinalSelection::MAX_VISITS and RootStrategy::SELECTION_POLICY, as
+        /// the action with the highest mean value or the best remaining action can still change after the stop
+        bool stopWhenBestIsUnreachable = false;
+        /// if > 0, stop early once the confidence interval (mean +- width * valueRange / sqrt(visits)) of the best root
+        /// action is separated from the intervals of all other root actions
+        float confidenceBoundWidth = 0;
+        /// how the final action is chosen from the root statistics. Ignored for sequential halving, which always
+        /// chooses the best of the remaining actions
+        FinalSelection finalSelection = FinalSelection::MAX_VALUE;
+        /// how root actions are selected. Sequential halving is preferable for small iteration budgets
+        RootStrategy rootStrategy = RootStrategy::SELECTION_POLICY;
+        /// share chance nodes of equal states (afterstates, e.g. the board after a move in 2048) that are reached by
+        /// different actions or paths, so that all of them refine the same subtree. Only used for problems with chance
+        /// events whose states specialize std::hash (see detail::IS_HASHABLE). States must not repeat along a path
+        bool shareAfterstates = false;
+        /// expand a single sampled event of a chance node per iteration instead of all events at once. Outcomes that
+        /// are never sampled are not materialized, which pays off for chance nodes with many events and for factored
+        /// chance events (consecutive chance stages, e.g. first the location and then the value of a tile)
+        bool lazyChanceExpansion = false;
     };
 
     Solver() = default;
@@ -72,19 +115,30 @@ class Solver
     [[nodiscard]] Parameter& parameter() { return params_; }
     [[nodiscard]] const Parameter& parameter() const { return params_; }
 
+    /// Seeds the selection and rollout policy (those that can be seeded), so that searches become reproducible
+    void seed(uint64_t seed)
+    {
+        if constexpr (detail::HAS_SEED<SelectionPolicy>) { selectionPolicy_.seed(seed); }
+        if constexpr (detail::HAS_SEED<RolloutPolicy>) { rolloutPolicy_.seed(splitMix64(seed)); }
+    }
+
     [[nodiscard]] bool isRunning() const { return running_; }
     [[nodiscard]] size_t currentIteration() const { return currentIteration_; }
 
     void printTopLevelUtilities() const;
-    [[nodiscard]] std::vector<std::pair<ActionType, Statistic<ValueType>>> getTopLevelUtilities() const;
+    [[nodiscard]] std::vector<std::pair<ActionType, StatisticType>> getTopLevelUtilities() const;
 
     [[nodiscard]] const TreeType& tree() const { return tree_; }
 
   private:
     void init(const ProblemType& problem, const StateType& root);
+    void runIterations();
     void iteration();
+    [[nodiscard]] bool canStopEarly() const;
+    [[nodiscard]] size_t bestActionIndex() const;
     [[nodiscard]] ActionType currentBestAction() const;
 
+    /// selects the node to expand and records the edges leading to it in path_
     [[nodiscard]] NodeId selection();
     [[nodiscard]] NodeId selectionOnce(const Node& node);
 
@@ -92,10 +146,23 @@ class Solver
     void expansion(Node& node);
     void expansion(const Node& node, DecisionNode& decNode);
     void expansion(Node& node, ChanceNode& chanceNode);
+    /// expands the child of the event that was sampled during selection, or of a newly sampled one
+    void expandChanceEvent(Node& node, ChanceNode& chanceNode);
+    /// inserts the child of a decision node or links it to an existing node with the same afterstate
+    EdgeId insertChild(const Node& parent, const StateType& state, const ValueVector& nodeValue);
+    void indexAfterstates();
 
-    [[nodiscard]] ValueVector rollout(NodeId currentNode);
+    static constexpr size_t MAX_CHILDREN = std::max(ProblemType::MAX_NUM_ACTIONS, ProblemType::MAX_CHANCE_EVENTS);
 
-    void backpropagate(const NodeId& expandedNode, const ValueVector& values);
+    [[nodiscard]] ValueVector rollout(NodeId currentNode);
+    /// value estimates (node value + rollout) of all children of the node, in the order of the outgoing edges
+    [[nodiscard]] zbo::MaxSizeVector<ValueVector, MAX_CHILDREN> rolloutChildren(const Node& node);
+
+    /// backpropagates the values (relative to the node value of the last node of path_) along the selected path. Nodes
+    /// can have several parents, so the path is needed to walk upwards
+    void backpropagate(ValueVector values);
+    /// backpropagates the values of a child that was just expanded through its edge and the selected path
+    void backpropagate(EdgeId newEdge, const ValueVector& values);
     void visitBackpropagate(Node& node, const Edge& edge, const ValueVector& values);
     void visitBackpropagate(DecisionNode& node, const Edge& edge, const ValueVector& values);
     void visitBackpropagate(ChanceNode& node, const Edge& edge, const ValueVector& values);
@@ -104,9 +171,23 @@ class Solver
     size_t currentIteration_ = 0;
     Parameter params_{};
 
+    static constexpr bool CAN_SHARE_AFTERSTATES = ProblemType::HAS_CHANCE_EVENTS && detail::IS_HASHABLE<StateType>;
+    /// expand and roll out on a single state that is restored with the undo interface of the problem
+    static constexpr bool ROLLOUT_IN_PLACE = detail::SUPPORTS_UNDO<ProblemType> &&
+                                             detail::HAS_ROLLOUT_IN_PLACE<RolloutPolicy, ProblemType> &&
+                                             !detail::HAS_ROLLOUT_BATCH<RolloutPolicy, ProblemType>;
+    using AfterstateMap =
+        std::conditional_t<CAN_SHARE_AFTERSTATES, std::unordered_map<StateType, NodeId>, std::monostate>;
+
     TreeType tree_{};
+    std::vector<EdgeId> path_{};
+    static constexpr size_t NO_EVENT = std::numeric_limits<size_t>::max();
+    /// event of the selected chance node that is not expanded yet (lazy chance expansion only)
+    size_t pendingEvent_{NO_EVENT};
+    AfterstateMap afterstates_{};
     SelectionPolicy selectionPolicy_{};
     RolloutPolicy rolloutPolicy_{};
+    SequentialHalving rootSchedule_{};
 };
 
 }  // namespace mcts
@@ -21,32 +21,67 @@
 // SOFTWARE.
 
 #pragma once
+#include "alias_table.h"
 #include "node_statistic.h"
 #include "zbo/max_size_vector.h"
 #include "zbo/named_type.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace mcts {
 
-struct NodeId : public zbo::NamedType<size_t, NodeId>, zbo::EqualityComparable<NodeId>
+template <typename IndexType>
+struct BasicNodeId : public zbo::NamedType<IndexType, BasicNodeId<IndexType>>,
+                     zbo::EqualityComparable<BasicNodeId<IndexType>>
 {
-    using NamedType::NamedType;
+    using zbo::NamedType<IndexType, BasicNodeId<IndexType>>::NamedType;
 };
 
-struct EdgeId : public zbo::NamedType<size_t, NodeId>, zbo::EqualityComparable<NodeId>
+template <typename IndexType>
+struct BasicEdgeId : public zbo::NamedType<IndexType, BasicEdgeId<IndexType>>,
+                     zbo::EqualityComparable<BasicEdgeId<IndexType>>
 {
-    using NamedType::NamedType;
+    using zbo::NamedType<IndexType, BasicEdgeId<IndexType>>::NamedType;
 };
 
-constexpr EdgeId ROOT_EDGE{std::numeric_limits<size_t>::max()};
-constexpr NodeId INVALID_NODE{std::numeric_limits<size_t>::max()};
+/// Default index type of the tree, no realistic tree exceeds 4 billion nodes
+using DefaultIndexType = uint32_t;
+using NodeId = BasicNodeId<DefaultIndexType>;
+using EdgeId = BasicEdgeId<DefaultIndexType>;
+
+constexpr EdgeId ROOT_EDGE{std::numeric_limits<DefaultIndexType>::max()};
+constexpr NodeId INVALID_NODE{std::numeric_limits<DefaultIndexType>::max()};
 constexpr NodeId ROOT_NODE{0};
 
-template <class ProblemType>
+template <class Problem, class Stat = Statistic<typename Problem::ValueType>, typename Index = DefaultIndexType>
 struct Tree
 {
+    using IndexType = Index;
+    using NodeId = BasicNodeId<IndexType>;
+    using EdgeId = BasicEdgeId<IndexType>;
+
+    static constexpr EdgeId ROOT_EDGE{std::numeric_limits<IndexType>::max()};
+    static constexpr NodeId INVALID_NODE{std::numeric_limits<IndexType>::max()};
+    static constexpr NodeId ROOT_NODE{0};
+
+    static_assert(std::is_unsigned_v<IndexType>, "Index type of the tree must be an unsigned integer");
+    static_assert(std::max(Problem::MAX_NUM_ACTIONS, Problem::MAX_CHANCE_EVENTS) <=
+                      std::numeric_limits<uint8_t>::max() + 1,
+                  "Edge index is stored in 8 bits");
+    static_assert(!Problem::HAS_CHANCE_EVENTS || Problem::MAX_CHANCE_EVENTS <= std::numeric_limits<uint8_t>::max(),
+                  "Edge indices of chance events are stored in 8 bits, 255 is reserved for ChanceNode::NOT_EXPANDED");
+
+    using ProblemType = Problem;
+    using StatisticType = Stat;
     using ValueType = typename ProblemType::ValueType;
     using ValueVector = typename ProblemType::ValueVector;
     using StateType = typename ProblemType::StateType;
@@ -62,12 +97,15 @@ struct Tree
          */
         struct DecisionNode
         {
-            explicit DecisionNode(const ProblemType& p, const StateType& s) noexcept
+            explicit DecisionNode([[maybe_unused]] const ProblemType& p, const StateType& s) noexcept
+                : playerId(s.getCurrentPlayer())
             {
-                actions = p.getAvailableActions(s);
-                playerId = s.getCurrentPlayer();
             }
-            NodeStatistic<ValueType, ProblemType::MAX_NUM_ACTIONS> statistics{};
+
+            /// generates the available actions, which is deferred until the node gets expanded the first time
+            void generateActions(const ProblemType& p, const StateType& s) { actions = p.getAvailableActions(s); }
+
+            NodeStatistic<ValueType, ProblemType::MAX_NUM_ACTIONS, StatisticType> statistics{};
             zbo::MaxSizeVector<ActionType, ProblemType::MAX_NUM_ACTIONS> actions{};
             uint8_t playerId{};
         };
@@ -78,11 +116,45 @@ struct Tree
          */
         struct ChanceNode
         {
-            explicit ChanceNode(const ProblemType& p, const StateType& s) noexcept
+            /// marks events without child in eventEdges, never a valid edge index (see the static_assert above)
+            static constexpr uint8_t NOT_EXPANDED = std::numeric_limits<uint8_t>::max();
+            using SamplerType = AliasTable<ProblemType::MAX_CHANCE_EVENTS>;
+
+            explicit ChanceNode([[maybe_unused]] const ProblemType& p, [[maybe_unused]] const StateType& s) noexcept {}
+
+            /// generates the possible chance events, which is deferred until the node gets expanded the first time
+            void generateEvents([[maybe_unused]] const ProblemType& p, [[maybe_unused]] const StateType& s)
             {
-                if constexpr (ProblemType::HAS_CHANCE_EVENTS) { events = p.getAvailableChanceEvents(s); }
+                if constexpr (ProblemType::HAS_CHANCE_EVENTS)
+                {
+                    events = p.getAvailableChanceEvents(s);
+                    eventEdges.fill(NOT_EXPANDED);
+                    buildSampler();
+                }
             }
+
+            /// builds the alias table of the events, which is kept out of line and shared by copies of the node
+            void buildSampler()
+            {
+                auto table = std::make_shared<SamplerType>();
+                table->build(events, [](const ChanceEventWithProbability& event) { return event.first; });
+                sampler = std::move(table);
+            }
+
+            /// index of the event that leads to the child behind the outgoing edge with the given index
+            [[nodiscard]] size_t eventIndex(uint8_t edgeIndex) const
+            {
+                return size_t(std::find(eventEdges.begin(), eventEdges.end(), edgeIndex) - eventEdges.begin());
+            }
+
             zbo::MaxSizeVector<ChanceEventWithProbability, ProblemType::MAX_CHANCE_EVENTS> events;
+            /// index of the outgoing edge of every event or NOT_EXPANDED. Without lazy chance expansion (see
+            /// Solver::Parameter::lazyChanceExpansion), all events are expanded at once in the order of the events
+            /// costs MAX_CHANCE_EVENTS bytes in every node, as the node payload is a variant
+            std::array<uint8_t, ProblemType::MAX_CHANCE_EVENTS> eventEdges{};
+            /// samples the events in constant time during selection. The table needs 3 bytes per event and is
+            /// immutable once built, so it lives on the heap and only takes a pointer in the node
+            std::shared_ptr<const SamplerType> sampler{};
         };
 
         using PayloadType = std::variant<DecisionNode, ChanceNode>;
@@ -103,16 +175,16 @@ struct Tree
         }
 
         explicit Node(const ProblemType& p, const StateType& s) noexcept
-            : state(s), problem(p), payload(payloadFromState(p, s))
+            : state(s), problem(p), terminal(p.isTerminal(s)), payload(payloadFromState(p, s))
         {
         }
 
         explicit Node(const ProblemType& p, const StateType& s, PayloadType payload) noexcept
-            : state(s), problem(p), payload(std::move(payload))
+            : state(s), problem(p), terminal(p.isTerminal(s)), payload(std::move(payload))
         {
         }
 
-        [[nodiscard]] constexpr bool isTerminal() const { return problem.isTerminal(state); }
+        [[nodiscard]] constexpr bool isTerminal() const { return terminal; }
         [[nodiscard]] constexpr bool isLeaf() const { return outgoingEdges.empty(); }
 
         [[nodiscard]] constexpr bool isChance() const { return std::holds_alternative<ChanceNode>(payload); }
@@ -131,6 +203,7 @@ struct Tree
         }
 
         NodeId nodeId{};
+        /// the edge the node was inserted with. Nodes shared with link() have further incoming edges
         EdgeId incomingEdge{ROOT_EDGE};
         zbo::MaxSizeVector<EdgeId, std::max(ProblemType::MAX_NUM_ACTIONS, ProblemType::MAX_CHANCE_EVENTS)>
             outgoingEdges{};
@@ -139,6 +212,8 @@ struct Tree
         const ProblemType& problem;
         /// saves the value (for each player) up to this node without looking into the future
         ValueVector nodeValue{};
+        /// whether the state is terminal, evaluated once on creation as the state never changes
+        bool terminal{false};
 
         /// Extra payload for type of nodes
         PayloadType payload;
@@ -146,10 +221,10 @@ struct Tree
 
     struct Edge
     {
-        Edge() : parent(INVALID_NODE), child(INVALID_NODE) {}
-        size_t index{};  ///< the index in the parents outgoing edges list
-        NodeId parent{};
-        NodeId child{};
+        NodeId parent{INVALID_NODE};
+        NodeId child{INVALID_NODE};
+        uint8_t index{};      ///< the index in the parents outgoing edges list
+        bool linked{false};  ///< the edge leads to a shared node and can have an offset(), see link()
     };
 
     Tree() = default;
@@ -164,6 +239,7 @@ struct Tree
     {
         nodes_.clear();
         edges_.clear();
+        offsets_.clear();
     }
 
     void reserve(size_t expectedNodes)
@@ -183,14 +259,19 @@ struct Tree
 
     [[nodiscard]] bool contains(NodeId node) const { return node.get() < nodes_.size(); }
 
-    [[nodiscard]] Tree subTree(NodeId parent) const
+    /// copies the subtree below parent, with room for additionalNodes further nodes (and edges) to be inserted
+    [[nodiscard]] Tree subTree(NodeId parent, size_t additionalNodes = 0) const
     {
         if (!contains(parent)) { return {}; }
 
+        const auto [numNodes, numEdges] = countSubTree(parent);
         Tree tree{};
-        tree.reserve(nodes_.capacity());
+        tree.nodes_.reserve(numNodes + additionalNodes);
+        tree.edges_.reserve(numEdges + additionalNodes);
         tree.setRoot((*this)[parent]);
-        insertExpandSubTree(tree, parent, ROOT_NODE);
+        std::vector<NodeId> newIds(nodes_.size(), INVALID_NODE);
+        newIds[parent.get()] = ROOT_NODE;
+        insertExpandSubTree(tree, parent, ROOT_NODE, newIds);
         tree.root().nodeValue = {};
         return tree;
     }
@@ -213,10 +294,11 @@ struct Tree
     {
         assert(nodes_.capacity() > nodes_.size());
         assert(edges_.capacity() > edges_.size());
+        assert(nodes_.size() < std::numeric_limits<IndexType>::max());
 
         // first add node to list of nodes_
-        NodeId newId{nodes_.size()};
-        EdgeId newEdgeId{edges_.size()};
+        NodeId newId{static_cast<IndexType>(nodes_.size())};
+        EdgeId newEdgeId{static_cast<IndexType>(edges_.size())};
         newNode.nodeId = newId;
         newNode.incomingEdge = newEdgeId;
         newNode.outgoingEdges = {};
@@ -226,30 +308,102 @@ struct Tree
         Edge newEdge{};
         newEdge.parent = parent;
         newEdge.child = newId;
-        newEdge.index = parentNode.outgoingEdges.size();
+        newEdge.index = static_cast<uint8_t>(parentNode.outgoingEdges.size());
         parentNode.outgoingEdges.push_back(newEdgeId);
         edges_.push_back(std::move(newEdge));
 
         return {newId, newEdgeId};
     }
 
+    /**
+     * @brief Adds an edge from the parent to an existing node, which is then shared by several parents (the tree is a
+     * directed acyclic graph then). Values backpropagated through the edge are shifted by the offset, so that it has
+     * to be the node value the parent implies for the child minus the stored node value of the child
+     */
+    EdgeId link(NodeId parent, NodeId child, const ValueVector& offset)
+    {
+        assert(edges_.capacity() > edges_.size());
+        assert(contains(child));
+
+        EdgeId newEdgeId{static_cast<IndexType>(edges_.size())};
+        auto& parentNode = (*this)[parent];
+        Edge newEdge{};
+        newEdge.parent = parent;
+        newEdge.child = child;
+        newEdge.index = static_cast<uint8_t>(parentNode.outgoingEdges.size());
+        parentNode.outgoingEdges.push_back(newEdgeId);
+        edges_.push_back(std::move(newEdge));
+        setOffset(newEdgeId, offset);
+        return newEdgeId;
+    }
+
+    /// value the path through the edge adds to the node value of its child, only linked edges can have one
+    [[nodiscard]] ValueVector offset(EdgeId edge) const
+    {
+        if (!(*this)[edge].linked) { return {}; }
+        return offsets_.at(edge.get());
+    }
+
     [[nodiscard]] const std::vector<Node>& nodes() const { return nodes_; }
     [[nodiscard]] const std::vector<Edge>& edges() const { return edges_; }
 
   private:
-    void insertExpandSubTree(Tree& tree, NodeId parent, NodeId newParent) const
+    /// number of nodes and edges below (and including) parent, nodes shared by several parents are counted once
+    [[nodiscard]] std::pair<size_t, size_t> countSubTree(NodeId parent) const
+    {
+        std::vector<bool> visited(nodes_.size(), false);
+        std::vector<NodeId> open{parent};
+        visited[parent.get()] = true;
+        size_t numNodes = 0;
+        size_t numEdges = 0;
+        while (!open.empty())
+        {
+            const auto& node = (*this)[open.back()];
+            open.pop_back();
+            numNodes++;
+            numEdges += node.outgoingEdges.size();
+            for (const EdgeId edge : node.outgoingEdges)
+            {
+                const auto child = (*this)[edge].child;
+                if (!visited[child.get()])
+                {
+                    visited[child.get()] = true;
+                    open.push_back(child);
+                }
+            }
+        }
+        return {numNodes, numEdges};
+    }
+
+    /// copies all descendants, newIds maps the ids of the nodes that were already copied to their new ids
+    void insertExpandSubTree(Tree& tree, NodeId parent, NodeId newParent, std::vector<NodeId>& newIds) const
     {
         for (const EdgeId edge : (*this)[parent].outgoingEdges)
         {
             auto childNodeId = (*this)[edge].child;
+            if (newIds[childNodeId.get()] != INVALID_NODE)
+            {
+                tree.link(newParent, newIds[childNodeId.get()], offset(edge));
+                continue;
+            }
             auto [nodeId, edgeId] = tree.insert(newParent, (*this)[childNodeId]);
+            if ((*this)[edge].linked) { tree.setOffset(edgeId, offset(edge)); }
             tree[nodeId].nodeValue -= tree.root().nodeValue;
-            insertExpandSubTree(tree, childNodeId, nodeId);
+            newIds[childNodeId.get()] = nodeId;
+            insertExpandSubTree(tree, childNodeId, nodeId, newIds);
         }
     }
 
+    void setOffset(EdgeId edge, const ValueVector& offset)
+    {
+        (*this)[edge].linked = true;
+        offsets_[edge.get()] = offset;
+    }
+
     std::vector<Node> nodes_;
     std::vector<Edge> edges_;
+    /// offsets of the linked edges, which are rare compared to all edges
+    std::unordered_map<IndexType, ValueVector> offsets_;
 };
 
 }  // namespace mcts
\ No newline at end of file
@@ -29,42 +29,42 @@
 
 namespace mcts::dot {
 
-template <typename ProblemType>
-void exportEdge(const typename Tree<ProblemType>::Edge& edge, const typename Tree<ProblemType>::Node node,
-                const typename Tree<ProblemType>::Node::DecisionNode& parentNode, std::ostream& stream)
+template <typename TreeType>
+void exportEdge(const typename TreeType::Edge& edge, const typename TreeType::Node node,
+                const typename TreeType::Node::DecisionNode& parentNode, std::ostream& stream)
 {
     using namespace std;
     const std::string edgeLabel = node.problem.actionToString(node.state, parentNode.actions[edge.index]);
     stream << edge.parent.get() << " -> " << edge.child.get() << "[label=\"" << edgeLabel << "\"];\n";
 }
 
-template <typename ProblemType>
-void exportEdge(const typename Tree<ProblemType>::Edge& edge, const typename Tree<ProblemType>::Node node,
-                const typename Tree<ProblemType>::Node::ChanceNode& parentNode, std::ostream& stream)
+template <typename TreeType>
+void exportEdge(const typename TreeType::Edge& edge, const typename TreeType::Node node,
+                const typename TreeType::Node::ChanceNode& parentNode, std::ostream& stream)
 {
-    if constexpr (ProblemType::HAS_CHANCE_EVENTS)
+    if constexpr (TreeType::ProblemType::HAS_CHANCE_EVENTS)
     {
         using namespace std;
-        const std::string edgeLabel = node.problem.eventToString(node.state, parentNode.events[edge.index].second);
-        const std::string tailLabel = to_string(parentNode.events[edge.index].first);
+        const auto& event = parentNode.events[parentNode.eventIndex(edge.index)];
+        const std::string edgeLabel = node.problem.eventToString(node.state, event.second);
+        const std::string tailLabel = to_string(event.first);
 
         stream << edge.parent.get() << " -> " << edge.child.get() << "[label=\"" << edgeLabel << "\", taillabel=\""
                << tailLabel << "\"];\n";
     }
 }
 
-template <typename ProblemType>
-void exportEdge(const typename Tree<ProblemType>::Edge& edge, const typename Tree<ProblemType>::Node& parentNode,
-                std::ostream& stream)
+template <typename TreeType>
+void exportEdge(const typename TreeType::Edge& edge, const typename TreeType::Node& parentNode, std::ostream& stream)
 {
     assert(edge.parent == parentNode.nodeId);
-    parentNode.visit([&edge, &stream](const typename Tree<ProblemType>::Node& par, const auto& node) {
-        exportEdge<ProblemType>(edge, par, node, stream);
+    parentNode.visit([&edge, &stream](const typename TreeType::Node& par, const auto& node) {
+        exportEdge<TreeType>(edge, par, node, stream);
     });
 }
 
-template <typename ProblemType>
-void exportNode(const typename Tree<ProblemType>::Node& node, const Tree<ProblemType>& tree, std::ostream& stream)
+template <typename TreeType>
+void exportNode(const typename TreeType::Node& node, const TreeType& tree, std::ostream& stream)
 {
     using namespace std;
 
@@ -77,21 +77,21 @@ void exportNode(const typename Tree<ProblemType>::Node& node, const Tree<Problem
     for (auto& edgeId : node.outgoingEdges)
     {
         const auto& edge = tree[edgeId];
-        exportEdge<ProblemType>(edge, node, stream);
+        exportEdge<TreeType>(edge, node, stream);
     }
 }
 
-template <typename ProblemType>
-void exportTreeToDot(const Tree<ProblemType>& tree, std::ostream& stream)
+template <typename ProblemType, typename... TreeArgs>
+void exportTreeToDot(const Tree<ProblemType, TreeArgs...>& tree, std::ostream& stream)
 {
     stream << "digraph mcts { \n";
-    for (const auto& node : tree.nodes()) { exportNode<ProblemType>(node, tree, stream); }
+    for (const auto& node : tree.nodes()) { exportNode(node, tree, stream); }
 
     stream << "}\n";
 }
 
-template <typename ProblemType>
-void exportTreeToDot(const Tree<ProblemType>& tree, const std::string filename)
+template <typename ProblemType, typename... TreeArgs>
+void exportTreeToDot(const Tree<ProblemType, TreeArgs...>& tree, const std::string filename)
 {
     std::ofstream file(filename);
     exportTreeToDot(tree, file);
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <functional>
 
 namespace mcts {
 enum class StageType
@@ -57,6 +58,21 @@ std::array<T, n> operator+(const std::array<T, n>& a1, const std::array<T, n>& a
     return retval;
 }
 
+template <typename T, size_t n>
+std::array<T, n> operator-(const std::array<T, n>& a1, const std::array<T, n>& a2)
+{
+    std::array<T, n> retval{};
+    std::transform(a1.begin(), a1.end(), a2.begin(), retval.begin(), std::minus{});
+    return retval;
+}
+
+template <typename T, size_t n>
+std::array<T, n>& operator-=(std::array<T, n>& a1, const std::array<T, n>& a2)
+{
+    a1 = a1 - a2;
+    return a1;
+}
+
 template <typename T, size_t n>
 std::array<T, n> operator*(const float f, const std::array<T, n>& a)
 {
@@ -0,0 +1,30 @@
+#include "mcts/alias_table.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+TEST(AliasTable, Distribution)
+{
+    constexpr size_t NUM_SAMPLES = 1U << 20U;
+    const std::vector<std::vector<float>> distributions = {
+        {1}, {0.8f, 0.2f}, {0.1f, 0, 0.6f, 0.3f}, {5, 1, 1, 1, 2}, {0.05f, 0.05f, 0.05f, 0.05f, 0.8f}};
+    for (const auto& probabilities : distributions)
+    {
+        mcts::AliasTable<8> table{};  // NOLINT
+        table.build(probabilities, [](float p) { return p; });
+        ASSERT_EQ(table.size(), probabilities.size());
+
+        // random numbers spread evenly over the 32 bit range
+        std::vector<size_t> counts(probabilities.size());
+        for (size_t i = 0; i < NUM_SAMPLES; ++i) { counts.at(table.sample(uint32_t(i << 12U)))++; }  // NOLINT
+
+        const float sum = std::accumulate(probabilities.begin(), probabilities.end(), 0.0f);
+        for (size_t event = 0; event < probabilities.size(); ++event)
+        {
+            EXPECT_NEAR(double(counts[event]) / NUM_SAMPLES, probabilities[event] / sum, 1e-4);  // NOLINT
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#include "mcts/grid_symmetry.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+TEST(GridSymmetry, Group)
+{
+    using Symmetry = mcts::GridSymmetry<4>;
+    constexpr uint64_t ALL_CELLS = (uint64_t(1) << Symmetry::NUM_CELLS) - 1;
+
+    // every symmetry is a different permutation of the cells and the composition of two is again one of them
+    for (size_t s1 = 0; s1 < Symmetry::NUM_SYMMETRIES; ++s1)
+    {
+        EXPECT_EQ(Symmetry::transform(s1, ALL_CELLS), ALL_CELLS);
+        for (size_t s2 = 0; s2 < Symmetry::NUM_SYMMETRIES; ++s2)
+        {
+            size_t numEqual = 0;
+            size_t numComposed = 0;
+            for (size_t s3 = 0; s3 < Symmetry::NUM_SYMMETRIES; ++s3)
+            {
+                bool equal = true;
+                bool composed = true;
+                for (size_t cell = 0; cell < Symmetry::NUM_CELLS; ++cell)
+                {
+                    equal = equal && Symmetry::transformCell(s1, cell) == Symmetry::transformCell(s3, cell);
+                    composed = composed && Symmetry::transformCell(s1, Symmetry::transformCell(s2, cell)) ==
+                                               Symmetry::transformCell(s3, cell);
+                }
+                numEqual += equal ? 1 : 0;
+                numComposed += composed ? 1 : 0;
+            }
+            EXPECT_EQ(numEqual, 1);
+            EXPECT_EQ(numComposed, 1);
+        }
+    }
+
+    // the empty board has all symmetries and the cells fall into the classes of corners, edges and center cells
+    EXPECT_EQ(Symmetry::stabilizer({0}), Symmetry::ALL);
+    EXPECT_EQ(Symmetry::representatives(ALL_CELLS, Symmetry::ALL), 0b100011);  // NOLINT
+
+    // a stone on the main diagonal only keeps the identity and the transposition
+    const uint64_t corner = 1;
+    EXPECT_EQ(Symmetry::stabilizer({corner}), Symmetry::IDENTITY | (1U << 4U));
+    EXPECT_EQ(Symmetry::canonical(std::array<uint64_t, 1>{uint64_t(1) << 15U}),  // NOLINT
+              Symmetry::canonical(std::array<uint64_t, 1>{corner}));
+}
@@ -0,0 +1,81 @@
+#include "mcts/random.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+std::vector<uint64_t> draw(const mcts::ThreadLocalEngine& engine, size_t count)
+{
+    std::vector<uint64_t> values;
+    for (size_t i = 0; i < count; ++i) { values.push_back(engine()); }
+    return values;
+}
+
+TEST(Random, ThreadLocalEngine)
+{
+    constexpr size_t COUNT = 10;
+    constexpr uint64_t SEED = 42;
+
+    mcts::ThreadLocalEngine engine(SEED);
+    const auto first = draw(engine, COUNT);
+    EXPECT_EQ(draw(mcts::ThreadLocalEngine(SEED), COUNT), first);
+    EXPECT_NE(draw(mcts::ThreadLocalEngine(SEED + 1), COUNT), first);
+
+    // copies continue the sequence of the original
+    const auto copy = engine;
+    const auto second = draw(copy, COUNT);
+    EXPECT_NE(second, first);
+    EXPECT_NE(draw(engine, COUNT), second);
+
+    engine.seed(SEED);
+    EXPECT_EQ(draw(engine, COUNT), first);
+}
+
+TEST(Random, EnginesAreReleased)
+{
+    constexpr size_t COUNT = 100;
+    constexpr uint64_t SEED = 42;
+    const auto& engines = mcts::detail::ThreadEngines::get().map;
+    const size_t numEngines = engines.size();
+
+    for (size_t i = 0; i < COUNT; ++i) { (void)draw(mcts::ThreadLocalEngine(i), 1); }
+    EXPECT_EQ(engines.size(), numEngines);
+
+    // seeding an engine without copies reseeds its engines instead of creating new ones
+    mcts::ThreadLocalEngine engine(SEED);
+    const auto first = draw(engine, COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        engine.seed(SEED);
+        EXPECT_EQ(draw(engine, COUNT), first);
+    }
+    EXPECT_EQ(engines.size(), numEngines + 1);
+}
+
+TEST(Random, ThreadStreams)
+{
+    constexpr size_t COUNT = 10;
+    constexpr size_t NUM_THREADS = 4;
+    const mcts::ThreadLocalEngine engine(7);  // NOLINT
+
+    // every thread draws from its own engine, seeded by the stream index of the thread
+    auto drawInThreads = [&engine]() {
+        std::vector<std::vector<uint64_t>> values(NUM_THREADS);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < NUM_THREADS; ++i)
+        {
+            threads.emplace_back([&engine, &values, i]() {
+                mcts::setThreadStream(i);
+                values[i] = draw(engine, COUNT);
+            });
+        }
+        for (auto& thread : threads) { thread.join(); }
+        return values;
+    };
+
+    const auto values = drawInThreads();
+    EXPECT_EQ(drawInThreads(), values);
+    for (size_t i = 1; i < NUM_THREADS; ++i) { EXPECT_NE(values[i], values[0]); }
+}
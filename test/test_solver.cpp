@@ -1,4 +1,8 @@
+#include "benchmarks/synthetic_problem.h"
+#include "mcts/expectimax.h"
 #include "mcts/problem.h"
+#include "mcts/selection/ucb1_tuned.h"
+#include "mcts/selection/ucb_v.h"
 #include "mcts/solver.h"
 #include "mcts/state.h"
 #include "mcts/tree_export.h"
@@ -7,7 +11,9 @@
 #include <gtest/gtest.h>
 
 #include <cassert>
+#include <cmath>
 #include <optional>
+#include <vector>
 
 enum class SelectCoin
 {
@@ -130,6 +136,54 @@ class RiggedToinCossProblem : public mcts::Problem<RiggedToinCossProblem, Proble
     mutable std::bernoulli_distribution bernoulli{PROBABILITY_HEADS};
 };
 
+/// Counts the calls to the problem that are done on the hot path of an iteration
+class CountingToinCossProblem : public RiggedToinCossProblem
+{
+  public:
+    [[nodiscard]] zbo::MaxSizeVector<ActionType, 2> getAvailableActions(const RiggedToinCossState& state) const
+    {
+        numGetAvailableActions++;
+        return RiggedToinCossProblem::getAvailableActions(state);
+    }
+
+    [[nodiscard]] auto getAvailableChanceEvents(const RiggedToinCossState& state) const
+    {
+        numGetAvailableChanceEvents++;
+        return RiggedToinCossProblem::getAvailableChanceEvents(state);
+    }
+
+    [[nodiscard]] bool isTerminal(const RiggedToinCossState& state) const
+    {
+        numIsTerminal++;
+        return RiggedToinCossProblem::isTerminal(state);
+    }
+
+    mutable size_t numGetAvailableActions = 0;
+    mutable size_t numGetAvailableChanceEvents = 0;
+    mutable size_t numIsTerminal = 0;
+};
+
+/// Implements the optional undo interface, so the solver works on a single state per expansion
+class UndoToinCossProblem : public RiggedToinCossProblem
+{
+  public:
+    void undoAction([[maybe_unused]] const ActionType action, RiggedToinCossState& state) const
+    {
+        assert(state.player == action);
+        numUndo++;
+        state.player.reset();
+    }
+
+    void undoChanceEvent([[maybe_unused]] const ChanceEventType& ce, RiggedToinCossState& state) const
+    {
+        assert(state.world == ce);
+        numUndo++;
+        state.world.reset();
+    }
+
+    mutable size_t numUndo = 0;
+};
+
 TEST(Problem, Constants)
 {
     RiggedToinCossProblem problem{};
@@ -184,4 +238,359 @@ TEST(Solver, GT)
         mcts::dot::exportTreeToDot<RiggedToinCossProblem>(solver.tree(), std::cout);
         mcts::dot::exportTreeToDot<RiggedToinCossProblem>(solver.tree(), "tree.dot");
     }
-}
\ No newline at end of file
+}
+
+TEST(Solver, LazyNodeEvaluation)
+{
+    RiggedToinCossState state{};
+    CountingToinCossProblem problem{};
+
+    mcts::Solver<CountingToinCossProblem> solver{};
+    solver.parameter().numIterations = 100;  // NOLINT
+    EXPECT_EQ(solver.run(problem, state), SelectCoin::HEADS);
+
+    // only expanded nodes need to know their actions/events: the root and both chance nodes below it
+    EXPECT_EQ(problem.numGetAvailableActions, 1);
+    EXPECT_EQ(problem.numGetAvailableChanceEvents, 2);
+
+    for (const auto& node : solver.tree())
+    {
+        if (node.isLeaf() && node.isDecision()) { EXPECT_TRUE(std::get<0>(node.payload).actions.empty()); }
+    }
+
+    // the tree is fully expanded, so further iterations only select and backpropagate without asking the problem
+    CountingToinCossProblem longRunProblem{};
+    solver.parameter().numIterations = 1000;  // NOLINT
+    EXPECT_EQ(solver.run(longRunProblem, state), SelectCoin::HEADS);
+    EXPECT_EQ(longRunProblem.numIsTerminal, problem.numIsTerminal);
+    EXPECT_EQ(longRunProblem.numGetAvailableActions, problem.numGetAvailableActions);
+}
+
+TEST(Solver, LazyChanceExpansion)
+{
+    RiggedToinCossProblem problem{};
+    mcts::Solver<RiggedToinCossProblem> solver{};
+    solver.parameter().numIterations = 1000;  // NOLINT
+    solver.parameter().lazyChanceExpansion = true;
+    EXPECT_EQ(solver.run(problem, RiggedToinCossState{}), SelectCoin::HEADS);
+
+    const auto& tree = solver.tree();
+    for (const auto& node : tree)
+    {
+        if (!node.isChance() || node.isLeaf()) { continue; }
+        // every child belongs to the event it was expanded for
+        const auto& chance = std::get<1>(node.payload);
+        size_t numExpanded = 0;
+        for (size_t event = 0; event < chance.events.size(); ++event)
+        {
+            const uint8_t edgeIndex = chance.eventEdges.at(event);
+            if (edgeIndex == mcts::Solver<RiggedToinCossProblem>::ChanceNode::NOT_EXPANDED) { continue; }
+            numExpanded++;
+            const auto& child = tree[tree[node.outgoingEdges[edgeIndex]].child];
+            EXPECT_EQ(child.state.world, chance.events[event].second);
+            EXPECT_EQ(chance.eventIndex(edgeIndex), event);
+        }
+        EXPECT_EQ(numExpanded, node.outgoingEdges.size());
+    }
+
+    for (const auto& [action, stat] : solver.getTopLevelUtilities())
+    {
+        const float expected = action == SelectCoin::HEADS ? RiggedToinCossProblem::PROBABILITY_HEADS
+                                                           : 1 - RiggedToinCossProblem::PROBABILITY_HEADS;
+        const double tolerance = 4 * std::sqrt(expected * (1 - expected) / stat.count());
+        EXPECT_NEAR(stat.value(), expected, tolerance);
+    }
+}
+
+TEST(Solver, UndoInterface)
+{
+    static_assert(mcts::detail::SUPPORTS_UNDO<UndoToinCossProblem>);
+    static_assert(!mcts::detail::SUPPORTS_UNDO<RiggedToinCossProblem>);
+
+    UndoToinCossProblem problem{};
+    RiggedToinCossState state{};
+    state.player = SelectCoin::TAILS;
+
+    // the in-place rollout has to leave the state untouched
+    mcts::RandomRolloutPolicy rolloutPolicy{};
+    for (int i = 0; i < 10; i++)  // NOLINT
+    {
+        rolloutPolicy.rolloutInPlace(state, problem);
+        EXPECT_EQ(state.player, SelectCoin::TAILS);
+        EXPECT_FALSE(state.world.has_value());
+    }
+    EXPECT_EQ(problem.numUndo, 10);
+
+    mcts::Solver<UndoToinCossProblem> solver{};
+    solver.parameter().numIterations = 1000;  // NOLINT
+    EXPECT_EQ(solver.run(problem, RiggedToinCossState{}), SelectCoin::HEADS);
+    EXPECT_GT(problem.numUndo, 10);
+
+    // the tree has to look the same as with copying the state
+    for (const auto& node : solver.tree())
+    {
+        if (node.nodeId == mcts::ROOT_NODE) { continue; }
+        const auto& edge = solver.tree()[node.incomingEdge];
+        const auto& parent = solver.tree()[edge.parent];
+        EXPECT_TRUE(node.state.player.has_value());
+        if (parent.isChance()) { EXPECT_EQ(node.state.world, std::get<1>(parent.payload).events[edge.index].second); }
+        else
+        {
+            EXPECT_FALSE(node.state.world.has_value());
+            EXPECT_EQ(node.state.player, std::get<0>(parent.payload).actions[edge.index]);
+        }
+    }
+
+    const auto utilities = solver.getTopLevelUtilities();
+    ASSERT_EQ(utilities.size(), 2);
+    for (const auto& [action, stat] : utilities)
+    {
+        const float expected = action == SelectCoin::HEADS ? RiggedToinCossProblem::PROBABILITY_HEADS
+                                                           : 1 - RiggedToinCossProblem::PROBABILITY_HEADS;
+        // the worse action is visited rarely, so allow four standard errors of the mean
+        const double tolerance = 4 * std::sqrt(expected * (1 - expected) / stat.count());
+        EXPECT_NEAR(stat.value(), expected, tolerance);
+    }
+}
+
+/// Rollout policy without rolloutInPlace, the solver has to copy states even for problems with undo interface
+class CopyingRolloutPolicy
+{
+  public:
+    template <class ProblemType>
+    typename ProblemType::ValueVector rollout(const typename ProblemType::StateType& state, const ProblemType& problem)
+    {
+        return policy_.rollout(state, problem);
+    }
+
+  private:
+    mcts::RandomRolloutPolicy policy_{};
+};
+
+TEST(Solver, UndoInterfaceWithoutInPlaceRollout)
+{
+    static_assert(!mcts::detail::HAS_ROLLOUT_IN_PLACE<CopyingRolloutPolicy, UndoToinCossProblem>);
+    static_assert(mcts::detail::HAS_ROLLOUT_IN_PLACE<mcts::RandomRolloutPolicy, UndoToinCossProblem>);
+
+    UndoToinCossProblem problem{};
+    mcts::Solver<UndoToinCossProblem, mcts::UCB1SelectionPolicy<float>, CopyingRolloutPolicy> solver{};
+    solver.parameter().numIterations = 1000;  // NOLINT
+    EXPECT_EQ(solver.run(problem, RiggedToinCossState{}), SelectCoin::HEADS);
+    EXPECT_EQ(problem.numUndo, 0);
+}
+
+TEST(Solver, StopWhenBestIsUnreachable)
+{
+    RiggedToinCossState state{};
+    RiggedToinCossProblem problem{};
+
+    mcts::Solver<RiggedToinCossProblem> solver{};
+    solver.parameter().numIterations = 100000;  // NOLINT
+    solver.parameter().stopWhenBestIsUnreachable = true;
+    solver.parameter().finalSelection = mcts::FinalSelection::MAX_VISITS;
+
+    auto action = solver.run(problem, state);
+    solver.printTopLevelUtilities();
+    EXPECT_EQ(action, SelectCoin::HEADS);
+    EXPECT_LT(solver.currentIteration(), solver.parameter().numIterations);
+
+    // the best action has more visits than the other could ever reach
+    auto utilities = solver.getTopLevelUtilities();
+    ASSERT_EQ(utilities.size(), 2);
+    const auto remaining = (solver.parameter().numIterations - solver.currentIteration()) * problem.MAX_NUM_ACTIONS;
+    EXPECT_GT(utilities[0].second.count(), utilities[1].second.count() + remaining);
+}
+
+TEST(Solver, StopWhenBestIsUnreachableNeedsMaxVisits)
+{
+    RiggedToinCossState state{};
+    RiggedToinCossProblem problem{};
+
+    // the action with the highest mean value can still change, so the visit counts must not stop the search
+    mcts::Solver<RiggedToinCossProblem> solver{};
+    solver.parameter().numIterations = 10000;  // NOLINT
+    solver.parameter().stopWhenBestIsUnreachable = true;
+    ASSERT_EQ(solver.parameter().finalSelection, mcts::FinalSelection::MAX_VALUE);
+
+    EXPECT_EQ(solver.run(problem, state), SelectCoin::HEADS);
+    EXPECT_EQ(solver.currentIteration(), solver.parameter().numIterations);
+}
+
+TEST(Solver, StopOnConfidenceBoundSeparation)
+{
+    RiggedToinCossState state{};
+    RiggedToinCossProblem problem{};
+
+    mcts::Solver<RiggedToinCossProblem> solver{};
+    solver.parameter().numIterations = 100000;  // NOLINT
+    solver.parameter().confidenceBoundWidth = 1.0f;
+
+    auto action = solver.run(problem, state);
+    solver.printTopLevelUtilities();
+    EXPECT_EQ(action, SelectCoin::HEADS);
+    EXPECT_LT(solver.currentIteration(), solver.parameter().numIterations);
+}
+
+TEST(SequentialHalving, Schedule)
+{
+    constexpr size_t NUM_ACTIONS = 4;
+    constexpr size_t BUDGET = 16;
+    constexpr std::array<float, NUM_ACTIONS> VALUES = {0.1f, 0.4f, 0.9f, 0.5f};
+
+    mcts::NodeStatistic<float, NUM_ACTIONS> statistics{};
+    mcts::SequentialHalving schedule{};
+    schedule.reset(BUDGET);
+
+    // first round: 2 rounds in total, so each action gets 16 / (4 * 2) = 2 visits
+    std::array<size_t, NUM_ACTIONS> visits{};
+    for (size_t i = 0; i < BUDGET / 2; ++i)
+    {
+        const auto action = schedule.next(statistics, NUM_ACTIONS);
+        visits.at(action)++;
+        statistics.visitWithValue(action, VALUES.at(action));
+    }
+    EXPECT_EQ(visits, (std::array<size_t, NUM_ACTIONS>{2, 2, 2, 2}));
+
+    // second round: only the better half remains
+    for (size_t i = 0; i < BUDGET / 2; ++i)
+    {
+        const auto action = schedule.next(statistics, NUM_ACTIONS);
+        EXPECT_TRUE(action == 2 || action == 3);
+        statistics.visitWithValue(action, VALUES.at(action));
+    }
+    EXPECT_EQ(schedule.best(statistics), 2);
+}
+
+TEST(Solver, SequentialHalving)
+{
+    RiggedToinCossState state{};
+    RiggedToinCossProblem problem{};
+
+    mcts::Solver<RiggedToinCossProblem> solver{};
+    solver.parameter().numIterations = 100;  // NOLINT
+    solver.parameter().rootStrategy = mcts::RootStrategy::SEQUENTIAL_HALVING;
+
+    auto action = solver.run(problem, state);
+    solver.printTopLevelUtilities();
+    EXPECT_EQ(action, SelectCoin::HEADS);
+}
+
+TEST(Expectimax, GT)
+{
+    struct ZeroHeuristic
+    {
+        float operator()(const RiggedToinCossState& /*state*/, const RiggedToinCossProblem& /*problem*/) const
+        {
+            return 0;
+        }
+    };
+    struct CoinKey
+    {
+        int operator()(const RiggedToinCossState& state) const
+        {
+            constexpr int NUM_VALUES = 100;
+            return int(state.player.value_or(SelectCoin{})) * NUM_VALUES + int(state.world.value_or(SelectCoin{}));
+        }
+    };
+
+    RiggedToinCossProblem problem{};
+    mcts::ExpectimaxSolver<RiggedToinCossProblem, ZeroHeuristic, CoinKey> solver{};
+
+    EXPECT_EQ(solver.run(problem, RiggedToinCossState{}), SelectCoin::HEADS);
+    EXPECT_FLOAT_EQ(solver.rootValue(), RiggedToinCossProblem::PROBABILITY_HEADS);
+    EXPECT_EQ(solver.statistics().numHeuristics, 0);
+}
+
+TEST(Solver, RunFromExistingTree)
+{
+    using Problem = synthetic::SyntheticProblem<4>;
+    synthetic::SyntheticConfig config{};
+    config.branchingFactor = 4;
+    config.depth = 30;  // NOLINT
+    const Problem problem(config);
+
+    mcts::Solver<Problem, mcts::UCB1SelectionPolicy<float>, mcts::RolloutPolicy<synthetic::SyntheticPolicy>> solver;
+    solver.parameter().numIterations = 500;  // NOLINT
+    solver.seed(1);
+    (void)solver.run(problem, problem.root());
+
+    // continue below the most visited child, which keeps a large part of the tree
+    const auto& root = solver.tree().root();
+    const auto& statistics = std::get<0>(root.payload).statistics;
+    size_t best = 0;
+    for (size_t i = 1; i < root.outgoingEdges.size(); ++i)
+    {
+        if (statistics.stat(i).count() > statistics.stat(best).count()) { best = i; }
+    }
+    const auto child = solver.tree()[root.outgoingEdges[best]].child;
+    const size_t numKept = solver.tree().subTree(child).nodeCount();
+
+    (void)solver.runFromExistingTree(child);
+    EXPECT_EQ(solver.currentIteration(), solver.parameter().numIterations);
+    EXPECT_GE(solver.tree().capacity(), numKept + solver.parameter().numIterations * Problem::MAX_NUM_ACTIONS);
+    EXPECT_LE(solver.tree().nodeCount(), solver.tree().capacity());
+}
+
+TEST(Statistic, Variance)
+{
+    mcts::VarianceStatistic<float> stat{};
+    for (const float value : {1.0f, 2.0f, 3.0f, 4.0f}) { stat.add(value); }
+
+    EXPECT_EQ(stat.count(), 4);
+    EXPECT_FLOAT_EQ(stat.value(), 2.5f);
+    EXPECT_FLOAT_EQ(stat.variance(), 1.25f);
+    EXPECT_FLOAT_EQ(stat.max(), 4.0f);
+}
+
+template <typename SelectionPolicy>
+class VarianceSolverTest : public testing::Test
+{
+};
+
+using VarianceSelectionPolicies =
+    testing::Types<mcts::UCB1TunedSelectionPolicy<float>, mcts::UCBVSelectionPolicy<float>>;
+TYPED_TEST_SUITE(VarianceSolverTest, VarianceSelectionPolicies);
+
+TYPED_TEST(VarianceSolverTest, GT)
+{
+    RiggedToinCossState state{};
+    RiggedToinCossProblem problem{};
+
+    mcts::Solver<RiggedToinCossProblem, TypeParam> solver{};
+    solver.parameter().numIterations = 1000;  // NOLINT
+
+    auto action = solver.run(problem, state);
+    solver.printTopLevelUtilities();
+    EXPECT_EQ(action, SelectCoin::HEADS);
+}
+
+/// Visits all actions equally often and declares no StatisticType, like selection policies written before it existed
+class RoundRobinSelectionPolicy : public mcts::SelectionPolicy<RoundRobinSelectionPolicy>
+{
+  public:
+    template <typename Node>
+    size_t selectDecisionNodeSuccessor(const Node&, const typename Node::DecisionNode& decision)
+    {
+        const auto& statistics = decision.statistics;
+        size_t leastVisited = 0;
+        for (size_t i = 1; i < decision.actions.size(); ++i)
+        {
+            if (statistics.stat(i).count() < statistics.stat(leastVisited).count()) { leastVisited = i; }
+        }
+        return leastVisited;
+    }
+};
+
+TEST(Solver, PolicyWithoutStatisticType)
+{
+    using Solver = mcts::Solver<RiggedToinCossProblem, RoundRobinSelectionPolicy>;
+    static_assert(std::is_same_v<Solver::StatisticType, mcts::Statistic<float>>);
+
+    RiggedToinCossState state{};
+    RiggedToinCossProblem problem{};
+
+    Solver solver{};
+    solver.parameter().numIterations = 1000;  // NOLINT
+
+    EXPECT_EQ(solver.run(problem, state), SelectCoin::HEADS);
+}
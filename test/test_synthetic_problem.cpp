@@ -0,0 +1,67 @@
+#include "benchmarks/synthetic_problem.h"
+#include "mcts/selection/ucb1.h"
+#include "mcts/solver.h"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+
+TEST(SyntheticProblem, Deterministic)
+{
+    using Problem = synthetic::SyntheticProblem<4, 3, 2>;
+    synthetic::SyntheticConfig config{};
+    config.branchingFactor = 4;
+    config.numEvents = 3;
+    config.depth = 6;  // NOLINT
+    config.chanceFraction = 0.3f;  // NOLINT
+    config.seed = 7;  // NOLINT
+
+    const Problem problem(config);
+    EXPECT_TRUE(problem.root() == Problem(config).root());
+    synthetic::SyntheticConfig otherSeed = config;
+    otherSeed.seed++;
+    EXPECT_FALSE(problem.root() == Problem(otherSeed).root());
+
+    // chance events are distributions and all paths end at the configured depth
+    size_t numChance = 0;
+    auto state = problem.root();
+    while (!problem.isTerminal(state))
+    {
+        if (problem.getNextStageType(state) == mcts::StageType::CHANCE)
+        {
+            numChance++;
+            const auto events = problem.getAvailableChanceEvents(state);
+            ASSERT_EQ(events.size(), 3);
+            float sum = 0;
+            for (const auto& event : events) { sum += event.first; }
+            EXPECT_NEAR(sum, 1, 1e-5);  // NOLINT
+            problem.performRandomChanceEvent(state);
+        }
+        else
+        {
+            EXPECT_EQ(problem.getAvailableActions(state).size(), 4);
+            problem.performAction(3, state);
+        }
+    }
+    EXPECT_EQ(state.depth, 6);
+    EXPECT_LT(numChance, 6);
+
+    // seeded searches on equal problems build equal trees
+    const auto search = [&config]() {
+        const Problem problem(config);
+        mcts::Solver<Problem, mcts::UCB1SelectionPolicy<float>, mcts::RolloutPolicy<synthetic::SyntheticPolicy>> solver;
+        solver.parameter().numIterations = 500;  // NOLINT
+        solver.seed(1);
+        (void)solver.run(problem, problem.root());
+        return std::make_pair(solver.tree().nodeCount(), solver.getTopLevelUtilities());
+    };
+    const auto [numNodes, utilities] = search();
+    const auto [numNodesAgain, utilitiesAgain] = search();
+    EXPECT_EQ(numNodes, numNodesAgain);
+    ASSERT_EQ(utilities.size(), utilitiesAgain.size());
+    for (size_t i = 0; i < utilities.size(); ++i)
+    {
+        EXPECT_EQ(utilities[i].second.count(), utilitiesAgain[i].second.count());
+        EXPECT_EQ(utilities[i].second.value(), utilitiesAgain[i].second.value());
+    }
+}
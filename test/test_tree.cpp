@@ -26,4 +26,68 @@ TEST(Tree, Init)
 
     ASSERT_EQ(tree[rootId].outgoingEdges.size(), 6);
     ASSERT_EQ(tree.nodeCount(), 7);
-}
\ No newline at end of file
+}
+
+TEST(Tree, IndexType)
+{
+    static_assert(sizeof(TTTTree::Edge) == 2 * sizeof(uint32_t) + sizeof(uint32_t));
+    static_assert(sizeof(TTTTree::NodeId) == sizeof(uint32_t));
+
+    using WideTree = mcts::Tree<ttt::TicTacToeProblem, TTTTree::StatisticType, uint64_t>;
+    static_assert(sizeof(WideTree::NodeId) == sizeof(uint64_t));
+
+    WideTree tree{};
+    TicTacToeState state{};
+    TicTacToeProblem p{};
+    tree.setRoot(WideTree::Node(p, state, WideTree::Node::DecisionNode(p, state)));
+    tree.reserve(10);
+
+    auto [nodeId, edgeId] =
+        tree.insert(WideTree::ROOT_NODE, WideTree::Node(p, state, WideTree::Node::DecisionNode(p, state)));
+    ASSERT_EQ(nodeId.get(), 1);
+    ASSERT_EQ(tree[edgeId].parent, WideTree::ROOT_NODE);
+    ASSERT_EQ(tree[edgeId].child, nodeId);
+    ASSERT_EQ(tree[edgeId].index, 0);
+}
+
+TEST(Tree, LinkSharedNode)
+{
+    TTTTree tree{};
+    TicTacToeState state{};
+    TicTacToeProblem p{};
+    tree.setRoot(TTTTree::Node(p, state, TTTTree::Node::DecisionNode(p, state)));
+    tree.reserve(10);
+
+    const TTTTree::Node node(p, state, TTTTree::Node::DecisionNode(p, state));
+    auto [first, firstEdge] = tree.insert(TTTTree::ROOT_NODE, node);
+    auto [second, secondEdge] = tree.insert(TTTTree::ROOT_NODE, node);
+    (void)secondEdge;
+    auto [shared, sharedEdge] = tree.insert(first, node);
+    const auto linkedEdge = tree.link(second, shared, {1, -1});
+
+    ASSERT_EQ(tree.nodeCount(), 4);
+    ASSERT_EQ(tree[linkedEdge].child, shared);
+    ASSERT_EQ(tree[linkedEdge].index, 0);
+    ASSERT_TRUE(tree[linkedEdge].linked);
+    ASSERT_FALSE(tree[sharedEdge].linked);
+    ASSERT_EQ(tree.offset(linkedEdge), (TTTTree::ValueVector{1, -1}));
+    ASSERT_EQ(tree.offset(firstEdge), TTTTree::ValueVector{});
+    ASSERT_EQ(tree[shared].incomingEdge, sharedEdge);
+
+    // the shared node is copied once and linked again, the offset is kept
+    const auto subTree = tree.subTree(TTTTree::ROOT_NODE);
+    ASSERT_EQ(subTree.nodeCount(), 4);
+    ASSERT_EQ(subTree.edges().size(), 4);
+    const auto firstCopy = subTree[subTree.root().outgoingEdges[0]].child;
+    const auto secondCopy = subTree[subTree.root().outgoingEdges[1]].child;
+    const auto& copiedLink = subTree[subTree[secondCopy].outgoingEdges[0]];
+    ASSERT_TRUE(copiedLink.linked);
+    ASSERT_EQ(copiedLink.child, subTree[subTree[firstCopy].outgoingEdges[0]].child);
+
+    // without the first parent, the shared node is inserted through the linked edge, which keeps its offset
+    const auto secondTree = tree.subTree(second);
+    ASSERT_EQ(secondTree.nodeCount(), 2);
+    const auto edge = secondTree.root().outgoingEdges[0];
+    ASSERT_TRUE(secondTree[edge].linked);
+    ASSERT_EQ(secondTree.offset(edge), (TTTTree::ValueVector{1, -1}));
+}